@@ -0,0 +1,21 @@
+#!/bin/bash
+
+# Functions marked with PROFILE_HOT must not construct ContentIds from string literals, because that
+# looks up the id map on every call. Use a ContentIdConstant instead.
+
+ID_TYPES=$(grep -ho "class [A-Za-z]* : public ContentId<" *.h | cut -d" " -f 2 | paste -sd "|")
+
+awk -v types="$ID_TYPES" '
+  /PROFILE_HOT;/ { depth = 1; next }
+  depth > 0 {
+    if ($0 ~ "(^|[^A-Za-z_])(" types ")\\(\"")
+      print FILENAME ":" FNR ": " $0
+    depth += gsub(/{/, "{") - gsub(/}/, "}")
+  }
+' *.cpp > /tmp/hot_paths
+
+if [ -s /tmp/hot_paths ]; then
+  cat /tmp/hot_paths
+  echo "======== Hot path check failed ========"
+  exit 1
+fi
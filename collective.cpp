@@ -58,6 +58,7 @@
 #include "immigrant_info.h"
 #include "item_types.h"
 #include "health_type.h"
+#include "collective_item_index.h"
 #include "village_control.h"
 #include "automaton_part.h"
 #include "enemy_aggression_level.h"
@@ -199,6 +200,7 @@ void Collective::addCreature(Creature* c, EnumSet<MinionTrait> traits) {
       if (col->getCreatures().contains(c))
         col->removeCreature(c);
   creatures.push_back(c);
+  immigration->onMinionsChanged();
   populationGroups.push_back({c});
   for (MinionTrait t : traits)
     byTrait[t].push_back(c);
@@ -215,6 +217,7 @@ void Collective::addCreature(Creature* c, EnumSet<MinionTrait> traits) {
 
 void Collective::removeCreature(Creature* c) {
   creatures.removeElement(c);
+  immigration->onMinionsChanged();
   setSteed(c, nullptr);
   for (auto& group : populationGroups)
     group.removeElementMaybe(c);
@@ -619,6 +622,8 @@ void Collective::tick() {
   dangerLevelCache = none;
   control->tick();
   zones->tick();
+  for (auto& pos : positionMatching->popChangedTargets())
+    taskMap->updateReachability(pos);
   taskMap->tick();
   constructions->clearUnsupportedFurniturePlans();
   dancing->setArea(zones->getPositions(ZoneId::LEISURE), getModel()->getLocalTime());
@@ -635,9 +640,12 @@ void Collective::tick() {
     updateConstructions();
   for (auto& workshop : workshops->types)
     workshop.second.updateState(this);
+  if (itemIndexCheck.isDue())
+    checkItemIndex();
   if (Random.roll(5)) {
-    for (Position pos : territory->getAll())
-      if (!isDelayed(pos) && pos.canEnterEmpty(MovementTrait::WALK) && !pos.getItems().empty())
+    auto itemPositions = itemIndex->getPositions(*territory);
+    for (Position pos : itemPositions)
+      if (!isDelayed(pos) && pos.canEnterEmpty(MovementTrait::WALK))
         fetchItems(pos);
     for (Position pos : zones->getPositions(ZoneId::FETCH_ITEMS))
       if (!isDelayed(pos) && pos.canEnterEmpty(MovementTrait::WALK))
@@ -942,6 +950,9 @@ void Collective::unclaimSquare(Position pos) {
   if (!territory->contains(pos))
     return;
   territory->remove(pos);
+  getModel()->updateTerritoryOwner(pos);
+  itemIndex->remove(pos);
+  immigration->onItemsChanged();
   for (auto layer : {FurnitureLayer::FLOOR, FurnitureLayer::MIDDLE, FurnitureLayer::CEILING})
     if (auto furniture = pos.modFurniture(layer))
       if (constructions->containsFurniture(pos, layer)) {
@@ -953,6 +964,9 @@ void Collective::unclaimSquare(Position pos) {
 void Collective::claimSquare(Position pos, bool includeStairs) {
   //CHECK(canClaimSquare(pos));
   territory->insert(pos);
+  getModel()->updateTerritoryOwner(pos);
+  itemIndex->update(pos);
+  immigration->onItemsChanged();
   addKnownTile(pos);
   for (auto layer : {FurnitureLayer::FLOOR, FurnitureLayer::MIDDLE, FurnitureLayer::CEILING})
     if (auto furniture = pos.modFurniture(layer))
@@ -1085,7 +1099,7 @@ vector<pair<Position, vector<Item*>>> Collective::getStoredItems(ItemIndex index
 vector<Item*> Collective::getAllItemsImpl(optional<ItemIndex> index, bool includeMinions) const {
   PROFILE;
   vector<Item*> allItems;
-  for (auto& v : territory->getAll())
+  for (auto& v : index ? itemIndex->getPositions(*territory, *index) : itemIndex->getPositions(*territory))
     append(allItems, index ? v.getItems(*index) : v.getItems());
   for (auto& v : zones->getPositions(ZoneId::STORAGE_EQUIPMENT))
     if (!territory->contains(v))
@@ -1098,7 +1112,7 @@ vector<Item*> Collective::getAllItemsImpl(optional<ItemIndex> index, bool includ
 
 int Collective::getNumItems(ItemIndex index, bool includeMinions) const {
   int ret = 0;
-  for (Position v : territory->getAll())
+  for (Position v : itemIndex->getPositions(*territory, index))
     ret += v.getItems(index).size();
   if (includeMinions)
     for (Creature* c : getCreatures())
@@ -1106,6 +1120,29 @@ int Collective::getNumItems(ItemIndex index, bool includeMinions) const {
   return ret;
 }
 
+void Collective::onItemsChanged(Position pos) {
+  if (territory->contains(pos)) {
+    itemIndex->update(pos);
+    immigration->onItemsChanged();
+  }
+}
+
+void Collective::checkItemIndex() const {
+  auto check = [&] (const vector<Position>& indexed, auto hasItems) {
+    PositionSet indexedSet;
+    for (auto& pos : indexed)
+      indexedSet.insert(pos);
+    CHECK(indexedSet.size() == indexed.size());
+    for (auto& pos : territory->getAll())
+      CHECK(hasItems(pos) == indexedSet.count(pos)) << "Item index out of date at " << pos.getCoord();
+    int numInTerritory = territory->getAll().filter([&](auto& pos) { return indexedSet.count(pos); }).size();
+    CHECK(numInTerritory == indexed.size()) << "Item index contains positions outside of territory";
+  };
+  check(itemIndex->getPositions(*territory), [](Position pos) { return !pos.getItems().empty(); });
+  for (auto index : ENUM_ALL(ItemIndex))
+    check(itemIndex->getPositions(*territory, index), [index](Position pos) { return !pos.getItems(index).empty(); });
+}
+
 void Collective::addKnownVillain(const Collective* col) {
   knownVillains.insert(col);
 }
@@ -1288,8 +1325,12 @@ void Collective::recalculateFurniturePopIncrease() {
 void Collective::onConstructed(Position pos, FurnitureType type) {
   if (pos.getFurniture(type)->forgetAfterBuilding()) {
     constructions->removeFurniturePlan(pos, getGame()->getContentFactory()->furniture.getData(type).getLayer());
-    if (territory->contains(pos))
+    if (territory->contains(pos)) {
       territory->remove(pos);
+      getModel()->updateTerritoryOwner(pos);
+      itemIndex->remove(pos);
+      immigration->onItemsChanged();
+    }
     control->onConstructed(pos, type);
     return;
   }
@@ -1313,6 +1354,9 @@ void Collective::onDestructed(Position pos, FurnitureType type, const DestroyAct
       break;
     case DestroyAction::Type::DIG:
       territory->insert(pos);
+      getModel()->updateTerritoryOwner(pos);
+      itemIndex->update(pos);
+      immigration->onItemsChanged();
       break;
     default:
       break;
@@ -1463,6 +1507,9 @@ bool Collective::addKnownTile(Position pos) {
   if (!knownTiles->isKnown(pos)) {
     pos.setNeedsRenderAndMemoryUpdate(true);
     knownTiles->addTile(pos, getModel());
+    taskMap->updateReachability(pos);
+    for (auto& v : pos.neighbors8())
+      taskMap->updateReachability(v);
     if (Task* task = taskMap->getMarked(pos))
       if (task->isBogus())
         taskMap->removeTask(task);
@@ -43,6 +43,7 @@ class CollectiveConfig;
 class CostInfo;
 struct TriggerInfo;
 class Territory;
+class CollectiveItemIndex;
 struct CollectiveName;
 class Workshops;
 class Zones;
@@ -222,6 +223,7 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   bool isKnownVillainLocation(const Collective*) const;
 
   void onEvent(const GameEvent&);
+  void onItemsChanged(Position);
 
   struct CurrentActivity {
     MinionActivity SERIAL(activity);
@@ -331,6 +333,9 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   DungeonLevel SERIAL(dungeonLevel);
   bool SERIAL(hadALeader) = false;
   vector<Item*> getAllItemsImpl(optional<ItemIndex>, bool includeMinions) const;
+  mutable HeapAllocated<CollectiveItemIndex> itemIndex;
+  void checkItemIndex() const;
+  CacheCheck itemIndexCheck;
   // Remove after alpha 27
   void updateBorderTiles();
   bool updatedBorderTiles = false;
@@ -0,0 +1,60 @@
+#include "stdafx.h"
+#include "collective_item_index.h"
+#include "territory.h"
+
+void CollectiveItemIndex::PositionList::set(Position pos, bool value) {
+  auto it = indexes.find(pos);
+  if (value && it == indexes.end()) {
+    indexes[pos] = elems.size();
+    elems.push_back(pos);
+  } else if (!value && it != indexes.end()) {
+    int index = it->second;
+    indexes.erase(it);
+    if (index != elems.size() - 1) {
+      elems[index] = elems.back();
+      indexes[elems[index]] = index;
+    }
+    elems.pop_back();
+  }
+}
+
+const vector<Position>& CollectiveItemIndex::getPositions(const Territory& territory) {
+  PROFILE;
+  if (!all) {
+    all.emplace();
+    for (auto& pos : territory.getAll())
+      if (!pos.getItems().empty())
+        all->set(pos, true);
+  }
+  return all->elems;
+}
+
+const vector<Position>& CollectiveItemIndex::getPositions(const Territory& territory, ItemIndex index) {
+  PROFILE;
+  auto& list = byIndex[index];
+  if (!list) {
+    list.emplace();
+    for (auto& pos : getPositions(territory))
+      if (!pos.getItems(index).empty())
+        list->set(pos, true);
+  }
+  return list->elems;
+}
+
+void CollectiveItemIndex::update(Position pos) {
+  if (!all)
+    return;
+  all->set(pos, !pos.getItems().empty());
+  for (auto index : ENUM_ALL(ItemIndex))
+    if (auto& list = byIndex[index])
+      list->set(pos, !pos.getItems(index).empty());
+}
+
+void CollectiveItemIndex::remove(Position pos) {
+  if (!all)
+    return;
+  all->set(pos, false);
+  for (auto index : ENUM_ALL(ItemIndex))
+    if (auto& list = byIndex[index])
+      list->set(pos, false);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "util.h"
+#include "position.h"
+#include "item_index.h"
+
+class Territory;
+
+/** Positions in a collective's territory that hold any items, and those that hold items of a given ItemIndex.
+    It's not serialized, it's built from the territory when first queried and then kept up to date by the
+    Collective on territory and item changes.*/
+class CollectiveItemIndex {
+  public:
+  const vector<Position>& getPositions(const Territory&);
+  const vector<Position>& getPositions(const Territory&, ItemIndex);
+  /** Must be called when the items change on a position that's in the territory, or the position is added to it.*/
+  void update(Position);
+  /** Must be called when a position is removed from the territory.*/
+  void remove(Position);
+
+  private:
+  struct PositionList {
+    void set(Position, bool);
+    vector<Position> elems;
+    HashMap<Position, int> indexes;
+  };
+  optional<PositionList> all;
+  EnumMap<ItemIndex, optional<PositionList>> byIndex;
+};
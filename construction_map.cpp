@@ -87,6 +87,7 @@ void ConstructionMap::onFurnitureDestroyed(Position pos, FurnitureLayer layer, F
       addDebt(info->getCost(), type.data());
       auto type = info->getFurnitureType();
       furniturePositions[type].erase(pos);
+      ++builtVersion;
       auto& storageIds = pos.getGame()->getContentFactory()->furniture.getData(type).getStorageId();
       for (auto id : storageIds)
         storagePositions[id].remove(pos);
@@ -105,6 +106,7 @@ void ConstructionMap::addFurniture(Position pos, const FurnitureInfo& info, Furn
   auto type = info.getFurnitureType();
   if (info.isBuilt(pos, layer)) {
     furniturePositions[type].insert(pos);
+    ++builtVersion;
     auto& storageIds = pos.getFurniture(layer)->getStorageId();
     for (auto id : storageIds)
       storagePositions[id].add(pos);
@@ -136,6 +138,10 @@ const PositionSet& ConstructionMap::getBuiltPositions(FurnitureType type) const
     return empty;
 }
 
+int ConstructionMap::getBuiltVersion() const {
+  return builtVersion;
+}
+
 const vector<pair<Position, FurnitureLayer>>& ConstructionMap::getAllFurniture() const {
   return allFurniture;
 }
@@ -145,6 +151,7 @@ void ConstructionMap::onConstructed(Position pos, FurnitureType type) {
   if (!containsFurniture(pos, layer))
     addFurniture(pos, FurnitureInfo::getBuilt(type), layer);
   furniturePositions[type].insert(pos);
+  ++builtVersion;
   auto& storageIds = pos.getGame()->getContentFactory()->furniture.getData(type).getStorageId();
   for (auto id : storageIds)
     storagePositions[id].add(pos);
@@ -45,6 +45,8 @@ class ConstructionMap {
   int getBuiltCount(FurnitureType) const;
   int getTotalCount(FurnitureType) const;
   const PositionSet& getBuiltPositions(FurnitureType) const;
+  /** Changes whenever the built positions of any furniture type change.*/
+  int getBuiltVersion() const;
   void onConstructed(Position, FurnitureType);
   void clearUnsupportedFurniturePlans();
 
@@ -70,4 +72,5 @@ class ConstructionMap {
   void addDebt(const CostInfo&, const char* reason);
   HashMap<StorageId, StoragePositions> SERIAL(storagePositions);
   StoragePositions SERIAL(allStoragePositions);
+  int builtVersion = 0;
 };
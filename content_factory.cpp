@@ -349,6 +349,8 @@ optional<string> ContentFactory::readZLevels(const GameConfig* config, KeyVerifi
 
 optional<string> ContentFactory::readData(const GameConfig* config, const vector<string>& modNames) {
   KeyVerifier keyVerifier;
+  config->preloadFiles(&keyVerifier);
+  OnExit onExit([&] { config->clearPreloadedFiles(); });
   vector<PrimaryId<StorageId>> storageIds;
   if (auto error = config->readObject(storageIds, GameConfigId::STORAGE_IDS, &keyVerifier))
     return *error;
@@ -30,8 +30,21 @@
 
 static const char* staticsInitialized = nullptr;
 
+static vector<const ContentIdConstantBase*>& getContentIdConstants() {
+  static vector<const ContentIdConstantBase*> ret;
+  return ret;
+}
+
+ContentIdConstantBase::ContentIdConstantBase() {
+  // Constants created later, eg. as function statics, would be interned on whatever thread runs first.
+  CHECK(!staticsInitialized) << "Content id constants must be declared at namespace scope";
+  getContentIdConstants().push_back(this);
+}
+
 void setInitializedStatics() {
   staticsInitialized = "initialized";
+  for (auto constant : getContentIdConstants())
+    constant->intern();
 }
 
 
@@ -53,6 +66,25 @@ int ContentId<T>::getId(const char* text) {
   return generatedId++;
 }
 
+template <typename T>
+const vector<string>& ContentId<T>::getInternTable() {
+  return getAllIds();
+}
+
+static bool isPrefix(const vector<string>& current, const vector<string>& table) {
+  return current.size() <= table.size() && std::equal(current.begin(), current.end(), table.begin());
+}
+
+template <typename T>
+bool ContentId<T>::restoreInternTable(const vector<string>& table) {
+  auto& current = getAllIds();
+  if (!isPrefix(current, table))
+    return false;
+  for (int i = current.size(); i < table.size(); ++i)
+    getId(table[i].data());
+  return true;
+}
+
 template <typename T>
 ContentId<T>::ContentId(const char* s) : id(getId(s)) {}
 
@@ -198,6 +230,34 @@ void PrimaryId<T>::serialize(PrettyInputArchive& ar1, const unsigned int) {\
 
 #include "text_serialization.h"
 
+#define CONTENT_ID_TYPES(X) \
+X(ViewId) \
+X(FurnitureType) \
+X(ItemListId) \
+X(EnemyId) \
+X(FurnitureListId) \
+X(SpellId) \
+X(TechId) \
+X(CreatureId) \
+X(SpellSchoolId) \
+X(CustomItemId) \
+X(BuildingId) \
+X(NameGeneratorId) \
+X(MapLayoutId) \
+X(RandomLayoutId) \
+X(LayoutMappingId) \
+X(BiomeId) \
+X(CollectiveResourceId) \
+X(WorkshopType) \
+X(StorageId) \
+X(TileGasType) \
+X(AttrType) \
+X(BuffId) \
+X(BodyMaterialId) \
+X(Keybinding) \
+X(AchievementId) \
+X(VillainGroup)
+
 #define INST(T) \
 SERIALIZABLE_TMPL(ContentId, T) \
 SERIALIZABLE_TMPL(PrimaryId, T) \
@@ -208,30 +268,27 @@ template void PrimaryId<T>::serialize(TextOutputArchive&, unsigned); \
 template std::ostream& operator <<(std::ostream& d, ContentId<T> id); \
 PRETTY_SPEC(T)
 
-INST(ViewId)
-INST(FurnitureType)
-INST(ItemListId)
-INST(EnemyId)
-INST(FurnitureListId)
-INST(SpellId)
-INST(TechId)
-INST(CreatureId)
-INST(SpellSchoolId)
-INST(CustomItemId)
-INST(BuildingId)
-INST(NameGeneratorId)
-INST(MapLayoutId)
-INST(RandomLayoutId)
-INST(LayoutMappingId)
-INST(BiomeId)
-INST(CollectiveResourceId)
-INST(WorkshopType)
-INST(StorageId)
-INST(TileGasType)
-INST(AttrType)
-INST(BuffId)
-INST(BodyMaterialId)
-INST(Keybinding)
-INST(AchievementId)
-INST(VillainGroup)
+CONTENT_ID_TYPES(INST)
 #undef INST
+
+ContentIdTables getContentIdTables() {
+  ContentIdTables ret;
+#define ADD_TABLE(T) ret.push_back(ContentId<T>::getInternTable());
+  CONTENT_ID_TYPES(ADD_TABLE)
+#undef ADD_TABLE
+  return ret;
+}
+
+bool restoreContentIdTables(const ContentIdTables& tables) {
+  auto current = getContentIdTables();
+  if (current.size() != tables.size())
+    return false;
+  for (int i : All(tables))
+    if (!isPrefix(current[i], tables[i]))
+      return false;
+  int index = 0;
+#define RESTORE_TABLE(T) ContentId<T>::restoreInternTable(tables[index++]);
+  CONTENT_ID_TYPES(RESTORE_TABLE)
+#undef RESTORE_TABLE
+  return true;
+}
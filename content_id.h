@@ -25,6 +25,12 @@ class ContentId {
   InternalId getInternalId() const;
   SERIALIZATION_DECL(ContentId)
 
+  // All ids interned so far, in the order of their internal ids.
+  static const vector<string>& getInternTable();
+  // Interns the ids from the table that aren't interned yet. Returns false without interning anything
+  // if the ids interned so far aren't a prefix of the table.
+  static bool restoreInternTable(const vector<string>&);
+
   private:
   friend PrimaryId<T>;
   InternalId id;
@@ -34,6 +40,43 @@ class ContentId {
 
 void setInitializedStatics();
 
+// Intern tables of all content id types. Content ids are ordered and hashed by their internal id, so
+// anything that deserializes content outside of the usual parse order should restore these first.
+using ContentIdTables = vector<vector<string>>;
+ContentIdTables getContentIdTables();
+// Returns false without interning anything if any of the types doesn't match the tables.
+bool restoreContentIdTables(const ContentIdTables&);
+
+class ContentIdConstantBase {
+  public:
+  ContentIdConstantBase();
+  virtual void intern() const = 0;
+};
+
+// An id constant for code that runs often, eg. in pathfinding. All constants are interned by
+// setInitializedStatics(), before any other thread starts, so conversions only read a cached number and
+// interning itself stays single-threaded. Declare at namespace scope:
+//   static const ContentIdConstant<FurnitureType> bridgeType("BRIDGE");
+template <typename Id>
+class ContentIdConstant : public ContentIdConstantBase {
+  public:
+  ContentIdConstant(const char* text) : text(text) {}
+
+  operator Id() const {
+    CHECK(id >= 0) << "Content id constant " << text << " used before setInitializedStatics()";
+    return Id(typename Id::InternalId(id));
+  }
+
+  virtual void intern() const override {
+    if (id < 0)
+      id = Id(text).getInternalId();
+  }
+
+  private:
+  const char* text;
+  mutable int id = -1;
+};
+
 template <typename T>
 class PrimaryId {
   public:
@@ -68,6 +68,10 @@
 #include "collective.h"
 #include "special_trait.h"
 
+static const ContentIdConstant<BuffId> swimmingSkill("SWIMMING_SKILL");
+static const ContentIdConstant<BuffId> fireImmunity("FIRE_IMMUNITY");
+static const ContentIdConstant<BuffId> bridgeBuildingSkill("BRIDGE_BUILDING_SKILL");
+
 template <class Archive>
 void Creature::serialize(Archive& ar, const unsigned int version) {
   if (Archive::is_saving::value)
@@ -2644,18 +2648,19 @@ MovementType Creature::getMovementType() const {
 }
 
 MovementType Creature::getSelfMovementType(Game* game, bool amSteed) const {
+  PROFILE_HOT;
   auto time = getGlobalTime();
   return MovementType(hasAlternativeViewId() ? TribeSet::getFull() : getFriendlyTribes(), {
       true,
       isAffected(LastingEffect::FLYING, time),
-      isAffected(BuffId("SWIMMING_SKILL")),
+      isAffected(swimmingSkill),
       getBody().canWade()})
     .setDestroyActions(EnumSet<DestroyAction::Type>([this](auto t) { return DestroyAction(t).canNavigate(this); }))
     .setForced((!amSteed && isAffected(LastingEffect::BLIND, time)) || getHoldingCreature() || forceMovement)
-    .setFireResistant(isAffected(BuffId("FIRE_IMMUNITY")))
+    .setFireResistant(isAffected(fireImmunity))
     .setSunlightVulnerable(isAffected(LastingEffect::SUNLIGHT_VULNERABLE, time)
         && (!game || game->getSunlightInfo().getState() == SunlightState::DAY))
-    .setCanBuildBridge(isAffected(BuffId("BRIDGE_BUILDING_SKILL")))
+    .setCanBuildBridge(isAffected(bridgeBuildingSkill))
     .setFarmAnimal(getBody().isFarmAnimal());
 }
 
@@ -2667,7 +2672,7 @@ MovementType Creature::getMovementType(Game* game) const {
         .setSunlightVulnerable((isAffected(LastingEffect::SUNLIGHT_VULNERABLE, time) ||
                 steed->isAffected(LastingEffect::SUNLIGHT_VULNERABLE, time))
             && (!game || game->getSunlightInfo().getState() == SunlightState::DAY))
-        .setFireResistant(isAffected(BuffId("FIRE_IMMUNITY")) && steed->isAffected(BuffId("FIRE_IMMUNITY")))
+        .setFireResistant(isAffected(fireImmunity) && steed->isAffected(fireImmunity))
         .setForced(isAffected(LastingEffect::BLIND, getGlobalTime()) || getHoldingCreature() || forceMovement);
   } else
     return getSelfMovementType(game, false);
@@ -2741,7 +2746,7 @@ bool Creature::canNavigateTo(Position pos) const {
 }
 
 CreatureAction Creature::moveTowards(Position pos, bool away, NavigationFlags flags) {
-  PROFILE;
+  PROFILE_HOT;
   CHECK(pos.isSameLevel(position));
   if (flags.stepOnTile && !pos.canEnterEmpty(this))
     return CreatureAction();
@@ -2777,7 +2782,7 @@ CreatureAction Creature::moveTowards(Position pos, bool away, NavigationFlags fl
               return action.append([path = *currentPath](Creature* c) { c->shortestPath = path; });
             }
           if (auto bridge = pos2.getFurniture(FurnitureLayer::GROUND)->getDefaultBridge())
-            if (isAffected(BuffId("BRIDGE_BUILDING_SKILL")))
+            if (isAffected(bridgeBuildingSkill))
               if (auto bridgeAction = construct(getPosition().getDir(pos2), *bridge))
                 return bridgeAction.append([path = *currentPath](Creature* c) { c->shortestPath = path; });
         }
@@ -76,6 +76,8 @@ void CreatureAttributes::serializeImpl(Archive& ar, const unsigned int version)
   ar(OPTION(killedByAchievement), OPTION(steedAchievement), OPTION(fixedAttr), OPTION(grantsExperience));
   for (auto& a : attr)
     a.second = max(0, a.second);
+  if (Archive::is_loading::value)
+    expLevelVersion = getNewExpLevelVersion();
 }
 
 template <class Archive>
@@ -160,7 +162,17 @@ const HashMap<AttrType, int>& CreatureAttributes::getMaxExpLevel() const {
   return maxLevelIncrease;
 }
 
+int CreatureAttributes::getExpLevelVersion() const {
+  return expLevelVersion;
+}
+
+int CreatureAttributes::getNewExpLevelVersion() {
+  static int lastVersion = 0;
+  return ++lastVersion;
+}
+
 void CreatureAttributes::increaseMaxExpLevel(AttrType type, int increase) {
+  expLevelVersion = getNewExpLevelVersion();
   maxLevelIncrease[type] = max(0, maxLevelIncrease[type] + increase);
   expLevel[type] = min<double>(expLevel[type], maxLevelIncrease[type]);
 }
@@ -168,6 +180,7 @@ void CreatureAttributes::increaseMaxExpLevel(AttrType type, int increase) {
 void CreatureAttributes::increaseExpLevel(AttrType type, double increase) {
   increase = max(0.0, min(increase, (double) maxLevelIncrease[type] - expLevel[type]));
   expLevel[type] += increase;
+  expLevelVersion = getNewExpLevelVersion();
 }
 
 bool CreatureAttributes::isTrainingMaxedOut(AttrType type) const {
@@ -78,6 +78,8 @@ class CreatureAttributes {
   void setDeathDescription(string);
   const Gender& getGender() const;
   double getExpLevel(AttrType) const;
+  // Changes whenever the experience levels change. Versions are unique among all attributes.
+  int getExpLevelVersion() const;
   const HashMap<AttrType, double>& getExpLevel() const;
   const HashMap<AttrType, int>& getMaxExpLevel() const;
   void increaseMaxExpLevel(AttrType, int increase);
@@ -162,6 +164,8 @@ class CreatureAttributes {
   EnumMap<LastingEffect, GlobalTime> SERIAL(lastingEffects);
   MinionActivityMap SERIAL(minionActivities);
   HashMap<AttrType, double> SERIAL(expLevel);
+  int expLevelVersion = getNewExpLevelVersion();
+  static int getNewExpLevelVersion();
   HashMap<AttrType, int> SERIAL(maxLevelIncrease);
   bool SERIAL(noAttackSound) = false;
   optional<CreatureId> SERIAL(creatureId);
@@ -48,6 +48,20 @@ DebugLog::Logger DebugLog::get() {
   return Logger(outputs);
 }
 
+bool CacheCheck::enabled = false;
+
+void CacheCheck::enable() {
+  enabled = true;
+}
+
+bool CacheCheck::isDue() {
+#ifdef RELEASE
+  return false;
+#else
+  return enabled && ++counter % 100 == 0;
+#endif
+}
+
 DebugLog InfoLog;
 DebugLog FatalLog;
 DebugLog UserInfoLog;
@@ -101,6 +101,19 @@ class DebugLog {
   std::vector<DebugOutput> outputs;
 };
 
+// Decides when to cross-check an incrementally updated cache against a full recomputation. The checks can cost
+// as much as the work the cache saves, so they only run in non-release builds started with --check_caches.
+class CacheCheck {
+  public:
+  static void enable();
+  // Returns true every 100th call if checks are enabled.
+  bool isDue();
+
+  private:
+  static bool enabled;
+  int counter = 0;
+};
+
 extern DebugLog InfoLog;
 extern DebugLog FatalLog;
 extern DebugLog UserErrorLog;
@@ -94,7 +94,17 @@ bool Equipment::canEquip(const Item* item, const Creature* c) const {
   return items[slot].size() < getMaxItems(slot, c);
 }
 
+int Equipment::getNewVersion() {
+  static int lastVersion = 0;
+  return ++lastVersion;
+}
+
+int Equipment::getVersion() const {
+  return version;
+}
+
 void Equipment::equip(Item* item, EquipmentSlot slot, Creature* c, const ContentFactory* factory) {
+  version = getNewVersion();
   items[slot].push_back(item);
   equipped.push_back(item);
   item->onEquip(c, true, factory);
@@ -102,6 +112,7 @@ void Equipment::equip(Item* item, EquipmentSlot slot, Creature* c, const Content
 }
 
 void Equipment::unequip(Item* item, Creature* c, const ContentFactory* factory) {
+  version = getNewVersion();
   items[item->getEquipmentSlot()].removeElement(item);
   equipped.removeElement(item);
   item->onUnequip(c, true, factory);
@@ -45,6 +45,8 @@ class Equipment {
   const ItemCounts& getCounts() const;
   void tick(Position, Creature*);
   bool containsAnyOf(const EntitySet<Item>&) const;
+  // Changes whenever an item is equipped or unequipped. Versions are unique among all equipments.
+  int getVersion() const;
 
   SERIALIZATION_DECL(Equipment)
 
@@ -54,6 +56,8 @@ class Equipment {
   Inventory SERIAL(inventory);
   EnumMap<EquipmentSlot, vector<Item*>> SERIAL(items);
   vector<Item*> SERIAL(equipped);
+  int version = getNewVersion();
+  static int getNewVersion();
   void onRemoved(Item*, Creature*, const ContentFactory*);
 };
 
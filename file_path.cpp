@@ -27,6 +27,13 @@ time_t FilePath::getModificationTime() const {
   return buf.st_mtime;
 }
 
+size_t FilePath::getSize() const {
+  struct stat buf;
+  if (stat(getPath(), &buf) != 0)
+    return 0;
+  return buf.st_size;
+}
+
 bool FilePath::exists() const {
 #ifdef WINDOWS
   struct _stat buf;
@@ -8,6 +8,7 @@ class FilePath {
   const char* getPath() const;
   const char* getFileName() const;
   time_t getModificationTime() const;
+  size_t getSize() const;
   bool exists() const;
   bool hasSuffix(const string&) const;
   FilePath withSuffix(const string& suf) const;
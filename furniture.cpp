@@ -30,12 +30,103 @@
   movementSet->addTrait(MovementTrait::WALK);
 }*/
 
+struct FurnitureDef {
+  string SERIAL(pluralName);
+  FurnitureLayer SERIAL(layer) = FurnitureLayer::MIDDLE;
+  optional<FurnitureType> SERIAL(burntRemains);
+  optional<FurnitureType> SERIAL(destroyedRemains);
+  heap_optional<ItemList> SERIAL(itemDrop);
+  EnumSet<VisionId> SERIAL(blockVision);
+  optional<FurnitureUsageType> SERIAL(usageType);
+  optional<FurnitureClickType> SERIAL(clickType);
+  optional<FurnitureOnBuilt> SERIAL(onBuilt);
+  heap_optional<FurnitureDroppedItems> SERIAL(droppedItems);
+  TimeInterval SERIAL(usageTime) = 1_visible;
+  bool SERIAL(overrideMovement) = false;
+  bool SERIAL(removeWithCreaturePresent) = true;
+  bool SERIAL(removeNonFriendly) = false;
+  bool SERIAL(wall) = false;
+  optional<ConstructMessage> SERIAL(constructMessage) = ConstructMessage::BUILD;
+  double SERIAL(lightEmission) = 0;
+  bool SERIAL(canHideHere) = false;
+  bool SERIAL(warning) = false;
+  optional<CreatureId> SERIAL(summonedElement);
+  optional<FurnitureType> SERIAL(defaultBridge);
+  optional<FurnitureType> SERIAL(fillPit);
+  bool SERIAL(noProjectiles) = false;
+  bool SERIAL(clearFogOfWar) = false;
+  bool SERIAL(xForgetAfterBuilding) = false;
+  double SERIAL(luxury) = 0;
+  BurnsDownMessage SERIAL(burnsDownMessage) = BurnsDownMessage::BURNS_DOWN;
+  HashMap<AttrType, int> SERIAL(maxTraining);
+  struct SupportInfo {
+    vector<Dir> SERIAL(dirs);
+    optional<ViewId> SERIAL(viewId);
+    SERIALIZE_ALL(NAMED(dirs), NAMED(viewId))
+  };
+  vector<SupportInfo> SERIAL(requiredSupport);
+  optional<FurnitureType> SERIAL(upgrade);
+  vector<FurnitureType> SERIAL(builtOver);
+  bool SERIAL(bridge) = false;
+  bool SERIAL(canSilentlyReplace) = false;
+  bool SERIAL(canBuildOutsideOfTerritory) = false;
+  bool SERIAL(requiresLight) = false;
+  optional<BedType> SERIAL(bedType);
+  Furniture::PopulationInfo SERIAL(populationIncrease) = {0, none};
+  optional<FXInfo> SERIAL(destroyFX);
+  optional<FXInfo> SERIAL(tryDestroyFX);
+  optional<FXInfo> SERIAL(walkOverFX);
+  optional<FXInfo> SERIAL(walkIntoFX);
+  optional<Sound> SERIAL(walkIntoSound);
+  optional<FXVariantName> SERIAL(usageFX);
+  optional<Sound> SERIAL(usageSound);
+  optional<Sound> SERIAL(destroySound) = Sound(SoundId("REMOVE_CONSTRUCTION"));
+  bool SERIAL(hostileSpell) = false;
+  optional<FurnitureEffectInfo> SERIAL(lastingEffect);
+  optional<FurnitureType> SERIAL(freezeTo);
+  struct MeltInfo {
+    optional<FurnitureType> SERIAL(meltTo);
+    SERIALIZE_ALL(OPTION(meltTo))
+  };
+  optional<MeltInfo> SERIAL(meltInfo);
+  optional<FurnitureType> SERIAL(dissolveTo);
+  optional<Effect> SERIAL(destroyedEffect);
+  optional<Effect> SERIAL(itemsRemovedEffect);
+  bool SERIAL(eyeball) = false;
+  vector<StorageId> SERIAL(storageIds);
+  bool SERIAL(hidesItems) = false;
+  optional<ViewId> SERIAL(emptyViewId);
+  optional<FurnitureType> SERIAL(diningFurniture);
+  optional<CreaturePredicate> SERIAL(usagePredicate);
+  optional<AchievementId> SERIAL(minedAchievement);
+  bool SERIAL(removeInstantly) = false;
+  bool SERIAL(buildingFloor) = false;
+  optional<FurnitureType> SERIAL(otherStairs);
+
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned version) {
+    ar(OPTION(removeNonFriendly), OPTION(canBuildOutsideOfTerritory), OPTION(pluralName), OPTION(burntRemains));
+    ar(OPTION(destroyedRemains), OPTION(itemDrop), OPTION(wall), OPTION(canSilentlyReplace), OPTION(blockVision));
+    ar(NAMED(usageType), NAMED(clickType), OPTION(usageTime), OPTION(overrideMovement), NAMED(constructMessage));
+    ar(OPTION(layer), OPTION(lightEmission), OPTION(canHideHere), OPTION(warning), NAMED(summonedElement));
+    ar(OPTION(droppedItems), OPTION(xForgetAfterBuilding), OPTION(requiredSupport), OPTION(builtOver));
+    ar(OPTION(defaultBridge), OPTION(noProjectiles), OPTION(clearFogOfWar), OPTION(removeWithCreaturePresent), OPTION(upgrade));
+    ar(OPTION(luxury), NAMED(onBuilt), OPTION(burnsDownMessage), OPTION(maxTraining), OPTION(bridge));
+    ar(OPTION(bedType), OPTION(requiresLight), OPTION(populationIncrease), OPTION(destroyFX), OPTION(tryDestroyFX), OPTION(walkOverFX));
+    ar(OPTION(walkIntoFX), OPTION(usageFX), OPTION(hostileSpell), OPTION(lastingEffect), NAMED(meltInfo), NAMED(dissolveTo));
+    ar(NAMED(destroyedEffect), NAMED(freezeTo), NAMED(fillPit), NAMED(itemsRemovedEffect));
+    ar(OPTION(eyeball), OPTION(storageIds), OPTION(hidesItems), NAMED(emptyViewId), OPTION(diningFurniture));
+    ar(OPTION(usagePredicate), OPTION(minedAchievement), OPTION(removeInstantly), OPTION(buildingFloor), OPTION(usageSound));
+    ar(OPTION(walkIntoSound), OPTION(destroySound), NAMED(otherStairs));
+  }
+};
+
 Furniture::Furniture(const Furniture&) = default;
 Furniture::Furniture(Furniture&&) noexcept = default;
 Furniture& Furniture::operator=(Furniture&&) = default;
 Furniture& Furniture::operator=(const Furniture&) = default;
 
-Furniture::Furniture() {
+Furniture::Furniture() : def(make_shared<FurnitureDef>()) {
   movementSet->addTrait(MovementTrait::WALK);
 }
 
@@ -43,33 +134,61 @@ Furniture::~Furniture() {}
 
 template<typename Archive>
 void Furniture::serializeImpl(Archive& ar, const unsigned version) {
-  ar(OPTION(viewObject), OPTION(removeNonFriendly), OPTION(canBuildOutsideOfTerritory));
-  ar(NAMED(name), OPTION(pluralName), OPTION(type), OPTION(movementSet), OPTION(fire), OPTION(burntRemains), OPTION(destroyedRemains));
-  ar(OPTION(destroyedInfo), OPTION(itemDrop), OPTION(wall), SKIP(creator), NAMED(createdTime), OPTION(canSilentlyReplace));
-  ar(OPTION(blockVision), NAMED(usageType), NAMED(clickType), NAMED(tickType), OPTION(usageTime), OPTION(overrideMovement));
-  ar(NAMED(constructMessage), OPTION(layer), OPTION(entryType), OPTION(lightEmission), OPTION(canHideHere), OPTION(warning));
-  ar(NAMED(summonedElement), OPTION(droppedItems), OPTION(xForgetAfterBuilding), OPTION(requiredSupport), OPTION(builtOver));
-  ar(OPTION(defaultBridge), OPTION(noProjectiles), OPTION(clearFogOfWar), OPTION(removeWithCreaturePresent), OPTION(upgrade));
-  ar(OPTION(luxury), NAMED(onBuilt), OPTION(burnsDownMessage), OPTION(maxTraining), OPTION(bridge));
-  ar(OPTION(bedType), OPTION(requiresLight), OPTION(populationIncrease), OPTION(destroyFX), OPTION(tryDestroyFX), OPTION(walkOverFX));
-  ar(OPTION(walkIntoFX), OPTION(usageFX), OPTION(hostileSpell), OPTION(lastingEffect), NAMED(meltInfo), NAMED(dissolveTo));
-  ar(OPTION(bloodCountdown), SKIP(bloodTime), NAMED(destroyedEffect), NAMED(freezeTo), NAMED(fillPit), NAMED(itemsRemovedEffect));
-  ar(OPTION(eyeball), OPTION(storageIds), OPTION(hidesItems), NAMED(emptyViewId), OPTION(diningFurniture));
-  ar(OPTION(usagePredicate), OPTION(minedAchievement), OPTION(removeInstantly), OPTION(buildingFloor), OPTION(usageSound));
-  ar(OPTION(walkIntoSound), OPTION(destroySound));
+  ar(OPTION(viewObject), NAMED(name), OPTION(type), OPTION(movementSet), OPTION(fire), OPTION(destroyedInfo));
+  ar(SKIP(creator), NAMED(createdTime), NAMED(tickType), OPTION(entryType), OPTION(bloodCountdown), SKIP(bloodTime));
+}
+
+// Loads saves written before the definition was split out, when all fields were stored inline.
+template<typename Archive>
+void Furniture::serializeLegacy(Archive& ar1, const unsigned version) {
+  auto& d = *def;
+  ar1(viewObject, d.removeNonFriendly, d.canBuildOutsideOfTerritory);
+  ar1(name, d.pluralName, type, movementSet, fire, d.burntRemains, d.destroyedRemains);
+  ar1(destroyedInfo, d.itemDrop, d.wall, creator, createdTime, d.canSilentlyReplace);
+  ar1(d.blockVision, d.usageType, d.clickType, tickType, d.usageTime, d.overrideMovement);
+  ar1(d.constructMessage, d.layer, entryType, d.lightEmission, d.canHideHere, d.warning);
+  ar1(d.summonedElement, d.droppedItems, d.xForgetAfterBuilding, d.requiredSupport, d.builtOver);
+  ar1(d.defaultBridge, d.noProjectiles, d.clearFogOfWar, d.removeWithCreaturePresent, d.upgrade);
+  ar1(d.luxury, d.onBuilt, d.burnsDownMessage, d.maxTraining, d.bridge);
+  ar1(d.bedType, d.requiresLight, d.populationIncrease, d.destroyFX, d.tryDestroyFX, d.walkOverFX);
+  ar1(d.walkIntoFX, d.usageFX, d.hostileSpell, d.lastingEffect, d.meltInfo, d.dissolveTo);
+  ar1(bloodCountdown, bloodTime, d.destroyedEffect, d.freezeTo, d.fillPit, d.itemsRemovedEffect);
+  ar1(d.eyeball, d.storageIds, d.hidesItems, d.emptyViewId, d.diningFurniture);
+  ar1(d.usagePredicate, d.minedAchievement, d.removeInstantly, d.buildingFloor, d.usageSound);
+  ar1(d.walkIntoSound, d.destroySound);
   if (version >= 1)
-    ar(NAMED(otherStairs));
+    ar1(d.otherStairs);
 }
 
 template <class Archive>
-void Furniture::serialize(Archive& ar1, const unsigned int v) {
+void Furniture::serialize(Archive& ar, const unsigned int v) {
   if (Archive::is_loading::value)
     movementSet->clearTraits();
-  serializeImpl(ar1, v);
+  if (v < 2) {
+    def = make_shared<FurnitureDef>();
+    serializeLegacy(ar, v);
+  } else {
+    ar(def);
+    serializeImpl(ar, v);
+  }
 }
 
 SERIALIZABLE(Furniture)
 
+static const FurnitureDef::SupportInfo* getSupportInfo(const FurnitureDef& def, Position pos) {
+  auto hasSupport = [&](const vector<Dir>& dirs) {
+    for (auto dir : dirs)
+      if (!pos.plus(Vec2(dir)).isWall())
+        return false;
+    return true;
+  };
+  for (int i : All(def.requiredSupport)) {
+    if (hasSupport(def.requiredSupport[i].dirs))
+      return &def.requiredSupport[i];
+  }
+  return nullptr;
+}
+
 const heap_optional<ViewObject>& Furniture::getViewObject() const {
   return viewObject;
 }
@@ -94,7 +213,7 @@ void Furniture::updateViewObject() {
 
 const string& Furniture::getName(int count) const {
   if (count > 1)
-    return pluralName;
+    return def->pluralName;
   else
     return name;
 }
@@ -122,42 +241,42 @@ const MovementSet& Furniture::getMovementSet() const {
 
 void Furniture::onEnter(Creature* c) const {
   if (entryType) {
-    auto f = c->getPosition().modFurniture(layer);
+    auto f = c->getPosition().modFurniture(def->layer);
     f->entryType->handle(f, c);
   }
 }
 
 void Furniture::onItemsRemoved(Position pos) const {
-  if (itemsRemovedEffect)
-    itemsRemovedEffect->apply(pos);
+  if (def->itemsRemovedEffect)
+    def->itemsRemovedEffect->apply(pos);
 }
 
 const heap_optional<ItemList>& Furniture::getItemDrop() const {
-  return itemDrop;
+  return def->itemDrop;
 }
 
 const vector<StorageId>& Furniture::getStorageId() const {
-  return storageIds;
+  return def->storageIds;
 }
 
 void Furniture::destroy(Position pos, const DestroyAction& action, Creature* destroyedBy) {
-  if (!destroyedEffect)
+  if (!def->destroyedEffect)
     pos.globalMessage("The " + name + " " + action.getIsDestroyed());
-  auto myLayer = layer;
+  auto myLayer = def->layer;
   auto myType = type;
-  if (itemDrop)
-    pos.dropItems(itemDrop->random(pos.getGame()->getContentFactory(), pos.getModelDifficulty()));
-  if (destroyFX)
-    pos.getGame()->addEvent(EventInfo::FX{pos, *destroyFX});
-  auto effect = destroyedEffect;
+  if (def->itemDrop)
+    pos.dropItems(def->itemDrop->random(pos.getGame()->getContentFactory(), pos.getModelDifficulty()));
+  if (def->destroyFX)
+    pos.getGame()->addEvent(EventInfo::FX{pos, *def->destroyFX});
+  auto effect = def->destroyedEffect;
   pos.removeFurniture(
       this,
-      destroyedRemains ? pos.getGame()->getContentFactory()->furniture.getFurniture(*destroyedRemains, getTribe()) : nullptr,
+      def->destroyedRemains ? pos.getGame()->getContentFactory()->furniture.getFurniture(*def->destroyedRemains, getTribe()) : nullptr,
       destroyedBy);
   if (effect)
     effect->apply(pos);
-  if (destroySound)
-    pos.addSound(*destroySound);
+  if (def->destroySound)
+    pos.addSound(*def->destroySound);
 }
 
 void Furniture::tryToDestroyBy(Position pos, Creature* c, const DestroyAction& action) {
@@ -166,8 +285,8 @@ void Furniture::tryToDestroyBy(Position pos, Creature* c, const DestroyAction& a
     info->health -= damage / info->strength;
     updateViewObject();
     pos.setNeedsRenderAndMemoryUpdate(true);
-    if (tryDestroyFX)
-      pos.getGame()->addEvent(EventInfo::FX{pos, *tryDestroyFX});
+    if (def->tryDestroyFX)
+      pos.getGame()->addEvent(EventInfo::FX{pos, *def->tryDestroyFX});
     if (info->health <= 0)
       destroy(pos, action, c);
     else
@@ -185,70 +304,56 @@ void Furniture::setTribe(TribeId id) {
 }
 
 bool Furniture::hasRequiredSupport(Position pos) const {
-  return requiredSupport.empty() || !!getSupportInfo(pos);
+  return def->requiredSupport.empty() || !!getSupportInfo(*def, pos);
 }
 
 bool Furniture::doesHideItems() const {
-  return hidesItems;
+  return def->hidesItems;
 }
 
 optional<FurnitureType> Furniture::getDiningFurnitureType() const {
-  return diningFurniture;
+  return def->diningFurniture;
 }
 
 const optional<CreaturePredicate>& Furniture::getUsagePredicate() const {
-  return usagePredicate;
+  return def->usagePredicate;
 }
 
 const optional<ViewId>& Furniture::getEmptyViewId() const {
-  return emptyViewId;
+  return def->emptyViewId;
 }
 
 const optional<AchievementId>& Furniture::getMinedAchievement() const {
-  return minedAchievement;
+  return def->minedAchievement;
 }
 
 bool Furniture::canRemoveInstantly() const {
-  return removeInstantly;
+  return def->removeInstantly;
 }
 
 bool Furniture::isBuildingFloor() const {
-  return buildingFloor;
+  return def->buildingFloor;
 }
 
 optional<FurnitureType> Furniture::getOtherStairs() const {
-  return otherStairs;
+  return def->otherStairs;
 }
 
 optional<ViewId> Furniture::getSupportViewId(Position pos) const {
-  if (auto ret = getSupportInfo(pos))
+  if (auto ret = getSupportInfo(*def, pos))
     return ret->viewId;
   return none;
 }
 
-const Furniture::SupportInfo* Furniture::getSupportInfo(Position pos) const {
-  auto hasSupport = [&](const vector<Dir>& dirs) {
-    for (auto dir : dirs)
-      if (!pos.plus(Vec2(dir)).isWall())
-        return false;
-    return true;
-  };
-  for (int i : All(requiredSupport)) {
-    if (hasSupport(requiredSupport[i].dirs))
-      return &requiredSupport[i];
-  }
-  return nullptr;
-}
-
-void Furniture::updateFire(Position pos, FurnitureLayer supposedLayer) {
+void Furniture::updateFire(Position pos, FurnitureLayer supposedLayer, vector<pair<Position, int>>& fireDamage) {
   PROFILE_BLOCK("Furniture::updateFire");
   PROFILE_BLOCK(type.data());
   if (fire && fire->isBurning()) {
     {
-      auto otherF = pos.getFurniture(layer);
-      auto otherFMod = pos.modFurniture(layer);
+      auto otherF = pos.getFurniture(def->layer);
+      auto otherFMod = pos.modFurniture(def->layer);
       CHECK(otherF == this)
-          << EnumInfo<FurnitureLayer>::getString(layer) << " "
+          << EnumInfo<FurnitureLayer>::getString(def->layer) << " "
           << EnumInfo<FurnitureLayer>::getString(supposedLayer) << " "
           << getName()
           << " " << (otherF ? (otherF->getName() + " " + EnumInfo<FurnitureLayer>::getString(otherF->getLayer())): "null"_s)
@@ -259,11 +364,11 @@ void Furniture::updateFire(Position pos, FurnitureLayer supposedLayer) {
       viewObject->setAttribute(ViewObject::Attribute::BURNING, min(1.0, double(burnState) / 50));
     INFO << getName() << " burning ";
     for (Position v : pos.neighbors8())
-      v.fireDamage(burnState / 5);
-    pos.fireDamage(burnState);
+      fireDamage.push_back(make_pair(v, burnState / 5));
+    fireDamage.push_back(make_pair(pos, burnState));
     fire->tick();
     if (fire->isBurntOut()) {
-      switch (burnsDownMessage) {
+      switch (def->burnsDownMessage) {
         case BurnsDownMessage::BURNS_DOWN:
           pos.globalMessage("The " + getName() + " burns down");
           break;
@@ -273,10 +378,10 @@ void Furniture::updateFire(Position pos, FurnitureLayer supposedLayer) {
       }
       pos.updateMovementDueToFire();
       pos.removeCreatureLight(false);
-      auto myLayer = layer;
+      auto myLayer = def->layer;
       auto myType = type;
-      pos.removeFurniture(this, burntRemains ?
-          pos.getGame()->getContentFactory()->furniture.getFurniture(*burntRemains, getTribe()) : nullptr);
+      pos.removeFurniture(this, def->burntRemains ?
+          pos.getGame()->getContentFactory()->furniture.getFurniture(*def->burntRemains, getTribe()) : nullptr);
       return;
     }
   }
@@ -292,56 +397,56 @@ void Furniture::tick(Position pos, FurnitureLayer supposedLayer) {
 }
 
 bool Furniture::blocksAnyVision() const {
-  return !blockVision.isEmpty();
+  return !def->blockVision.isEmpty();
 }
 
 bool Furniture::canSeeThru(VisionId id) const {
-  return !blockVision.contains(id);
+  return !def->blockVision.contains(id);
 }
 
 bool Furniture::stopsProjectiles(VisionId id) const {
-  return !canSeeThru(id) || noProjectiles;
+  return !canSeeThru(id) || def->noProjectiles;
 }
 
 bool Furniture::overridesMovement() const {
-  return overrideMovement;
+  return def->overrideMovement;
 }
 
 void Furniture::click(Position pos) const {
-  if (clickType) {
-    FurnitureClick::handle(*clickType, pos, this);
+  if (def->clickType) {
+    FurnitureClick::handle(*def->clickType, pos, this);
     pos.setNeedsRenderAndMemoryUpdate(true);
   }
 }
 
 void Furniture::use(Position pos, Creature* c) const {
-  if (usageType)
-    FurnitureUsage::handle(*usageType, pos, this, c);
-  if (usageSound)
-    pos.addSound(*usageSound);
+  if (def->usageType)
+    FurnitureUsage::handle(*def->usageType, pos, this, c);
+  if (def->usageSound)
+    pos.addSound(*def->usageSound);
 }
 
 bool Furniture::canUse(const Creature* c) const {
-  if (usageType)
-    return FurnitureUsage::canHandle(*usageType, c);
+  if (def->usageType)
+    return FurnitureUsage::canHandle(*def->usageType, c);
   else
     return true;
 }
 
 optional<FurnitureUsageType> Furniture::getUsageType() const {
-  return usageType;
+  return def->usageType;
 }
 
 bool Furniture::hasUsageType(BuiltinUsageId id) const {
-  return usageType && usageType->getReferenceMaybe<BuiltinUsageId>() == id;
+  return def->usageType && def->usageType->getReferenceMaybe<BuiltinUsageId>() == id;
 }
 
 TimeInterval Furniture::getUsageTime() const {
-  return usageTime;
+  return def->usageTime;
 }
 
 optional<FurnitureClickType> Furniture::getClickType() const {
-  return clickType;
+  return def->clickType;
 }
 
 optional<FurnitureTickType> Furniture::getTickType() const {
@@ -357,15 +462,15 @@ bool Furniture::isTicking() const {
 }
 
 bool Furniture::isWall() const {
-  return wall;
+  return def->wall;
 }
 
 void Furniture::onConstructedBy(Position pos, Creature* c) {
   if (c) {
     creator = c;
     createdTime = c->getLocalTime();
-    if (constructMessage)
-      switch (*constructMessage) {
+    if (def->constructMessage)
+      switch (*def->constructMessage) {
         case ConstructMessage::BUILD:
           c->thirdPerson(c->getName().the() + " builds " + addAParticle(getName()));
           c->secondPerson("You build " + addAParticle(getName()));
@@ -384,22 +489,22 @@ void Furniture::onConstructedBy(Position pos, Creature* c) {
           break;
       }
   }
-  if (onBuilt)
-    handleOnBuilt(pos, this, *onBuilt);
+  if (def->onBuilt)
+    handleOnBuilt(pos, this, *def->onBuilt);
 }
 
 void Furniture::beforeRemoved(Position pos) const {
-  if (onBuilt)
-    handleBeforeRemoved(pos, this, *onBuilt);
+  if (def->onBuilt)
+    handleBeforeRemoved(pos, this, *def->onBuilt);
 }
 
 bool Furniture::isStairs() const {
-  return onBuilt && !!getStairDirection(*onBuilt);
+  return def->onBuilt && !!getStairDirection(*def->onBuilt);
 }
 
 optional<Position> Furniture::getSecondPart(Position pos) const {
-  if (onBuilt)
-    if (auto dir = getStairDirection(*onBuilt)) {
+  if (def->onBuilt)
+    if (auto dir = getStairDirection(*def->onBuilt)) {
       int myIndex = *pos.getModel()->getMainLevelDepth(pos.getLevel());
       int nextIndex = pos.getModel()->getMainLevelsDepth().clamp(myIndex + *dir);
       if (nextIndex != myIndex)
@@ -409,30 +514,30 @@ optional<Position> Furniture::getSecondPart(Position pos) const {
 }
 
 FurnitureLayer Furniture::getLayer() const {
-  return layer;
+  return def->layer;
 }
 
 double Furniture::getLightEmission() const {
   if (fire && fire->isBurning())
     return Level::getCreatureLightRadius();
   else
-    return lightEmission;
+    return def->lightEmission;
 }
 
 bool Furniture::canHide() const {
-  return canHideHere;
+  return def->canHideHere;
 }
 
 bool Furniture::emitsWarning(const Creature*) const {
-  return warning;
+  return def->warning;
 }
 
 bool Furniture::canRemoveWithCreaturePresent() const {
-  return removeWithCreaturePresent && !wall;
+  return def->removeWithCreaturePresent && !def->wall;
 }
 
 bool Furniture::canRemoveNonFriendly() const {
-  return removeNonFriendly;
+  return def->removeNonFriendly;
 }
 
 Creature* Furniture::getCreator() const {
@@ -447,29 +552,29 @@ optional<LocalTime> Furniture::getCreatedTime() const {
 }
 
 optional<CreatureId> Furniture::getSummonedElement() const {
-  return summonedElement;
+  return def->summonedElement;
 }
 
 bool Furniture::isClearFogOfWar() const {
-  return clearFogOfWar;
+  return def->clearFogOfWar;
 }
 
 bool Furniture::forgetAfterBuilding() const {
-  return xForgetAfterBuilding;
+  return def->xForgetAfterBuilding;
 }
 
 void Furniture::onCreatureWalkedOver(Position pos, Vec2 direction) const {
-  if (walkOverFX)
-    pos.getGame()->addEvent((EventInfo::FX{pos, *walkOverFX, direction}));
+  if (def->walkOverFX)
+    pos.getGame()->addEvent((EventInfo::FX{pos, *def->walkOverFX, direction}));
 }
 
 void Furniture::onCreatureWalkedInto(Position pos, Vec2 direction) const {
   auto game = pos.getGame();
-  if (walkIntoFX) {
-    game->addEvent((EventInfo::FX{pos, *walkIntoFX, direction}));
+  if (def->walkIntoFX) {
+    game->addEvent((EventInfo::FX{pos, *def->walkIntoFX, direction}));
   }
-  if (walkIntoSound)
-    pos.addSound(*walkIntoSound);
+  if (def->walkIntoSound)
+    pos.addSound(*def->walkIntoSound);
 }
 
 bool Furniture::onBloodNear(Position pos) {
@@ -490,64 +595,64 @@ void Furniture::spreadBlood(Position pos) {
     name = "bloody " + name;
     viewObject->setDescription(capitalFirst(name));
     for (auto v : pos.neighbors4())
-      if (auto f = v.getFurniture(layer))
+      if (auto f = v.getFurniture(def->layer))
         if (!!f->bloodCountdown) {
-          v.modFurniture(layer)->bloodTime = pos.getModel()->getLocalTime() + 1_visible;
-          v.getLevel()->addBurningFurniture(v.getCoord(), layer);
+          v.modFurniture(def->layer)->bloodTime = pos.getModel()->getLocalTime() + 1_visible;
+          v.getLevel()->addBurningFurniture(v.getCoord(), def->layer);
         }
   }
 }
 
 int Furniture::getMaxTraining(AttrType t) const {
-  return getValueMaybe(maxTraining, t).value_or(0);
+  return getValueMaybe(def->maxTraining, t).value_or(0);
 }
 
 const HashMap<AttrType, int>& Furniture::getMaxTraining() const {
-  return maxTraining;
+  return def->maxTraining;
 }
 
 optional<FurnitureType> Furniture::getUpgrade() const {
-  return upgrade;
+  return def->upgrade;
 }
 
 optional<FXVariantName> Furniture::getUsageFX() const {
-  return usageFX;
+  return def->usageFX;
 }
 
 
 vector<PItem> Furniture::dropItems(Position pos, vector<PItem> v) const {
-  if (droppedItems) {
-    return droppedItems->handle(pos, this, std::move(v));
+  if (def->droppedItems) {
+    return def->droppedItems->handle(pos, this, std::move(v));
   } else
     return v;
 }
 
 optional<FurnitureType> Furniture::getDefaultBridge() const {
-  return defaultBridge;
+  return def->defaultBridge;
 }
 
 optional<FurnitureType> Furniture::getFillPit() const {
-  return fillPit;
+  return def->fillPit;
 }
 
 double Furniture::getLuxury() const {
-  return luxury;
+  return def->luxury;
 }
 
 const Furniture::PopulationInfo& Furniture::getPopulationIncrease() const {
-  return populationIncrease;
+  return def->populationIncrease;
 }
 
 const vector<FurnitureType>& Furniture::getBuiltOver() const {
-  return builtOver;
+  return def->builtOver;
 }
 
 bool Furniture::isBridge() const {
-  return bridge;
+  return def->bridge;
 }
 
 bool Furniture::silentlyReplace() const {
-  return canSilentlyReplace;
+  return def->canSilentlyReplace;
 }
 
 void Furniture::setType(FurnitureType t) {
@@ -555,27 +660,27 @@ void Furniture::setType(FurnitureType t) {
 }
 
 bool Furniture::buildOutsideOfTerritory() const {
-  return canBuildOutsideOfTerritory;
+  return def->canBuildOutsideOfTerritory;
 }
 
 bool Furniture::isRequiresLight() const {
-  return requiresLight;
+  return def->requiresLight;
 }
 
 bool Furniture::isHostileSpell() const {
-  return hostileSpell;
+  return def->hostileSpell;
 }
 
 bool Furniture::isEyeball() const {
-  return eyeball;
+  return def->eyeball;
 }
 
 optional<BedType> Furniture::getBedType() const {
-  return bedType;
+  return def->bedType;
 }
 
 const optional<FurnitureEffectInfo>& Furniture::getLastingEffectInfo() const {
-  return lastingEffect;
+  return def->lastingEffect;
 }
 
 Furniture& Furniture::setBlocking() {
@@ -604,9 +709,9 @@ bool Furniture::canDestroy(const Position& pos, const MovementType& movement, co
 }
 
 bool Furniture::acidDamage(Position pos) {
-  if (dissolveTo) {
+  if (def->dissolveTo) {
     pos.globalMessage("The " + getName() + " is dissolved");
-    PFurniture replace = pos.getGame()->getContentFactory()->furniture.getFurniture(*dissolveTo, getTribe());
+    PFurniture replace = pos.getGame()->getContentFactory()->furniture.getFurniture(*def->dissolveTo, getTribe());
     pos.removeFurniture(this, std::move(replace));
     return true;
   }
@@ -618,11 +723,11 @@ bool Furniture::acidDamage(Position pos) {
 }
 
 bool Furniture::fireDamage(Position pos, bool withMessage) {
-  if (meltInfo) {
+  if (def->meltInfo) {
     pos.globalMessage("The " + getName() + " melts");
     PFurniture replace;
-    if (meltInfo->meltTo)
-      replace = pos.getGame()->getContentFactory()->furniture.getFurniture(*meltInfo->meltTo, getTribe());
+    if (def->meltInfo->meltTo)
+      replace = pos.getGame()->getContentFactory()->furniture.getFurniture(*def->meltInfo->meltTo, getTribe());
     pos.removeFurniture(this, std::move(replace));
     return true;
   }
@@ -635,7 +740,7 @@ bool Furniture::fireDamage(Position pos, bool withMessage) {
       if (viewObject)
         viewObject->setAttribute(ViewObject::Attribute::BURNING, 0.3);
       pos.updateMovementDueToFire();
-      pos.getLevel()->addBurningFurniture(pos.getCoord(), layer);
+      pos.getLevel()->addBurningFurniture(pos.getCoord(), def->layer);
       pos.addCreatureLight(false);
       return true;
     }
@@ -644,9 +749,9 @@ bool Furniture::fireDamage(Position pos, bool withMessage) {
 }
 
 bool Furniture::iceDamage(Position pos) {
-  if (freezeTo) {
+  if (def->freezeTo) {
     pos.globalMessage("The " + getName() + " freezes");
-    pos.removeFurniture(this, pos.getGame()->getContentFactory()->furniture.getFurniture(*freezeTo, getTribe()));
+    pos.removeFurniture(this, pos.getGame()->getContentFactory()->furniture.getFurniture(*def->freezeTo, getTribe()));
     return true;
   }
   return false;
@@ -719,6 +824,9 @@ void Furniture::serialize(PrettyInputArchive& ar1, unsigned int v) {
     if (auto depth = viewObject->getAttribute(ViewObjectAttribute::WATER_DEPTH))
       waterDepth = *depth;
   ar1(NAMED(waterDepth));
+  // The definition may be shared with the furniture that this one inherits from.
+  def = make_shared<FurnitureDef>(*def);
+  def->serialize(ar1, v);
   serializeImpl(ar1, v);
   ar1(endInput());
   if (blockMovement.value)
@@ -729,7 +837,7 @@ void Furniture::serialize(PrettyInputArchive& ar1, unsigned int v) {
     for (auto& elem : *strength2)
       setDestroyable(elem.first, elem.second);
   if (viewId)
-    viewObject = ViewObject(*viewId, viewLayer.value_or(getViewLayer(layer)), capitalFirst(getName()));
+    viewObject = ViewObject(*viewId, viewLayer.value_or(getViewLayer(def->layer)), capitalFirst(getName()));
   if (attachmentDir)
     viewObject->setAttachmentDir(*attachmentDir);
   if (waterDepth)
@@ -737,7 +845,7 @@ void Furniture::serialize(PrettyInputArchive& ar1, unsigned int v) {
   if (blockingEnemies.value)
     setBlockingEnemies();
   if (blockAllVision.value)
-    blockVision = EnumSet<VisionId>::fullSet();
-  if (pluralName.empty())
-    pluralName = makePlural(name);
+    def->blockVision = EnumSet<VisionId>::fullSet();
+  if (def->pluralName.empty())
+    def->pluralName = makePlural(name);
 }
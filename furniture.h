@@ -35,6 +35,7 @@ class ViewObject;
 class MovementSet;
 class Effect;
 class FurnitureUsageType;
+struct FurnitureDef;
 
 RICH_ENUM(
     BurnsDownMessage,
@@ -91,7 +92,8 @@ class Furniture {
   bool acidDamage(Position);
   bool iceDamage(Position);
   void tick(Position, FurnitureLayer supposedLayer);
-  void updateFire(Position, FurnitureLayer supposedLayer);
+  /** Fire damage to this and neighboring squares is appended to fireDamage instead of being applied immediately.*/
+  void updateFire(Position, FurnitureLayer supposedLayer, vector<pair<Position, int>>& fireDamage);
   bool canSeeThru(VisionId) const;
   bool blocksAnyVision() const;
   bool stopsProjectiles(VisionId) const;
@@ -183,99 +185,32 @@ class Furniture {
   optional<FurnitureTickType> SERIAL(tickType);
 
   private:
+  // Everything that comes from the game config and never changes after loading lives in the definition,
+  // which is shared between the FurnitureFactory prototype and all instances of the type.
+  shared_ptr<FurnitureDef> SERIAL(def);
   heap_optional<ViewObject> SERIAL(viewObject);
   string SERIAL(name);
-  string SERIAL(pluralName);
   FurnitureType SERIAL(type);
-  FurnitureLayer SERIAL(layer) = FurnitureLayer::MIDDLE;
   HeapAllocated<MovementSet> SERIAL(movementSet);
   heap_optional<Fire> SERIAL(fire);
-  optional<FurnitureType> SERIAL(burntRemains);
-  optional<FurnitureType> SERIAL(destroyedRemains);
   struct DestroyedInfo {
     double SERIAL(health);
     double SERIAL(strength);
     SERIALIZE_ALL(health, strength)
   };
   EnumMap<DestroyAction::Type, optional<DestroyedInfo>> SERIAL(destroyedInfo);
-  heap_optional<ItemList> SERIAL(itemDrop);
-  EnumSet<VisionId> SERIAL(blockVision);
-  optional<FurnitureUsageType> SERIAL(usageType);
-  optional<FurnitureClickType> SERIAL(clickType);
-  optional<FurnitureOnBuilt> SERIAL(onBuilt);
   heap_optional<FurnitureEntry> SERIAL(entryType);
-  heap_optional<FurnitureDroppedItems> SERIAL(droppedItems);
-  TimeInterval SERIAL(usageTime) = 1_visible;
-  bool SERIAL(overrideMovement) = false;
-  bool SERIAL(removeWithCreaturePresent) = true;
-  bool SERIAL(removeNonFriendly) = false;
-  bool SERIAL(wall) = false;
-  optional<ConstructMessage> SERIAL(constructMessage) = ConstructMessage::BUILD;
-  double SERIAL(lightEmission) = 0;
-  bool SERIAL(canHideHere) = false;
-  bool SERIAL(warning) = false;
   WeakPointer<Creature> SERIAL(creator);
   optional<LocalTime> SERIAL(createdTime);
-  optional<CreatureId> SERIAL(summonedElement);
-  optional<FurnitureType> SERIAL(defaultBridge);
-  optional<FurnitureType> SERIAL(fillPit);
-  bool SERIAL(noProjectiles) = false;
-  bool SERIAL(clearFogOfWar) = false;
-  bool SERIAL(xForgetAfterBuilding) = false;
-  double SERIAL(luxury) = 0;
+  optional<int> SERIAL(bloodCountdown);
+  optional<LocalTime> SERIAL(bloodTime);
   void updateViewObject();
-  BurnsDownMessage SERIAL(burnsDownMessage) = BurnsDownMessage::BURNS_DOWN;
   template<typename Archive>
   void serializeImpl(Archive&, const unsigned);
-  HashMap<AttrType, int> SERIAL(maxTraining);
-  struct SupportInfo {
-    vector<Dir> SERIAL(dirs);
-    optional<ViewId> SERIAL(viewId);
-    SERIALIZE_ALL(NAMED(dirs), NAMED(viewId))
-  };
-  vector<SupportInfo> SERIAL(requiredSupport);
-  const Furniture::SupportInfo* getSupportInfo(Position) const;
-  optional<FurnitureType> SERIAL(upgrade);
-  vector<FurnitureType> SERIAL(builtOver);
-  bool SERIAL(bridge) = false;
-  bool SERIAL(canSilentlyReplace) = false;
-  bool SERIAL(canBuildOutsideOfTerritory) = false;
-  bool SERIAL(requiresLight) = false;
-  optional<BedType> SERIAL(bedType);
-  PopulationInfo SERIAL(populationIncrease) = {0, none};
-  optional<FXInfo> SERIAL(destroyFX);
-  optional<FXInfo> SERIAL(tryDestroyFX);
-  optional<FXInfo> SERIAL(walkOverFX);
-  optional<FXInfo> SERIAL(walkIntoFX);
-  optional<Sound> SERIAL(walkIntoSound);
-  optional<FXVariantName> SERIAL(usageFX);
-  optional<Sound> SERIAL(usageSound);
-  optional<Sound> SERIAL(destroySound) = Sound(SoundId("REMOVE_CONSTRUCTION"));
-  bool SERIAL(hostileSpell) = false;
-  optional<FurnitureEffectInfo> SERIAL(lastingEffect);
-  optional<FurnitureType> SERIAL(freezeTo);
-  struct MeltInfo {
-    optional<FurnitureType> SERIAL(meltTo);
-    SERIALIZE_ALL(OPTION(meltTo))
-  };
-  optional<MeltInfo> SERIAL(meltInfo);
-  optional<FurnitureType> SERIAL(dissolveTo);
-  optional<int> SERIAL(bloodCountdown);
-  optional<LocalTime> SERIAL(bloodTime);
-  optional<Effect> SERIAL(destroyedEffect);
-  optional<Effect> SERIAL(itemsRemovedEffect);
-  bool SERIAL(eyeball) = false;
-  vector<StorageId> SERIAL(storageIds);
-  bool SERIAL(hidesItems) = false;
-  optional<ViewId> SERIAL(emptyViewId);
-  optional<FurnitureType> SERIAL(diningFurniture);
-  optional<CreaturePredicate> SERIAL(usagePredicate);
-  optional<AchievementId> SERIAL(minedAchievement);
-  bool SERIAL(removeInstantly) = false;
-  bool SERIAL(buildingFloor) = false;
-  optional<FurnitureType> SERIAL(otherStairs);
+  template<typename Archive>
+  void serializeLegacy(Archive&, const unsigned);
 };
 
 static_assert(std::is_nothrow_move_constructible<Furniture>::value, "T should be noexcept MoveConstructible");
 
-CEREAL_CLASS_VERSION(Furniture, 1)
\ No newline at end of file
+CEREAL_CLASS_VERSION(Furniture, 2)
\ No newline at end of file
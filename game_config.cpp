@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include "game_config.h"
 #include "pretty_printing.h"
+#include "pretty_archive.h"
+#include <future>
 
 const char* GameConfig::getConfigName(GameConfigId id) {
   switch (id) {
@@ -87,3 +89,87 @@ const char* GameConfig::getConfigName(GameConfigId id) {
 
 GameConfig::GameConfig(vector<DirectoryPath> modDirs) : dirs(std::move(modDirs)) {
 }
+
+vector<FilePath> GameConfig::getPaths(GameConfigId id) const {
+  vector<FilePath> paths;
+  string fileName = getConfigName(id) + ".txt"_s;
+  for (auto& dir : dirs) {
+    auto path = dir.file(fileName);
+    if (path.exists())
+      paths.push_back(std::move(path));
+  }
+  return paths;
+}
+
+struct GameConfig::Preloaded {
+  KeyVerifier* keyVerifier;
+  map<GameConfigId, std::future<PrettyPrinting::PreparedInput>> inputs;
+  vector<pair<vector<FilePath>, std::promise<PrettyPrinting::PreparedInput>>> jobs;
+  std::atomic<int> nextJob {0};
+  vector<thread> threads;
+  ~Preloaded() {
+    // Files that weren't requested yet won't be needed.
+    nextJob = jobs.size();
+    for (auto& t : threads)
+      t.join();
+  }
+};
+
+void GameConfig::preloadFiles(KeyVerifier* keyVerifier) const {
+  preloaded = make_shared<Preloaded>();
+  preloaded->keyVerifier = keyVerifier;
+  for (int i = 0; i <= int(GameConfigId::ACHIEVEMENTS); ++i) {
+    auto id = GameConfigId(i);
+    preloaded->jobs.emplace_back(getPaths(id), std::promise<PrettyPrinting::PreparedInput>());
+    preloaded->inputs.insert(make_pair(id, preloaded->jobs.back().second.get_future()));
+  }
+  int numThreads = min<int>(preloaded->jobs.size(), max<int>(1, std::thread::hardware_concurrency()));
+  auto jobs = preloaded.get();
+  for (int i = 0; i < numThreads; ++i)
+    preloaded->threads.push_back(makeThread([jobs] {
+      for (int index = jobs->nextJob++; index < jobs->jobs.size(); index = jobs->nextJob++) {
+        auto& job = jobs->jobs[index];
+        try {
+          job.second.set_value(PrettyPrinting::prepareInput(job.first, jobs->keyVerifier));
+        } catch (...) {
+          // Rethrown by getInput on the reading thread.
+          job.second.set_exception(std::current_exception());
+        }
+      }
+    }));
+}
+
+void GameConfig::clearPreloadedFiles() const {
+  preloaded = nullptr;
+}
+
+PrettyPrinting::PreparedInput GameConfig::getInput(GameConfigId id, KeyVerifier* keyVerifier) const {
+  if (preloaded && preloaded->keyVerifier == keyVerifier)
+    if (auto input = getReferenceMaybe(preloaded->inputs, id)) {
+      auto ret = input->get();
+      preloaded->inputs.erase(id);
+      return ret;
+    }
+  return PrettyPrinting::prepareInput(getPaths(id), keyVerifier);
+}
+
+static void hashDirectory(const DirectoryPath& dir, vector<size_t>& hashes) {
+  auto files = dir.getFiles();
+  sort(files.begin(), files.end(), [](const FilePath& f1, const FilePath& f2) {
+    return strcmp(f1.getFileName(), f2.getFileName()) < 0; });
+  for (auto& file : files)
+    hashes.push_back(combineHash(string(file.getFileName()), file.getSize(), file.getModificationTime()));
+  auto subdirs = dir.getSubDirs();
+  sort(subdirs.begin(), subdirs.end());
+  for (auto& subdir : subdirs) {
+    hashes.push_back(combineHash(subdir));
+    hashDirectory(dir.subdirectory(subdir), hashes);
+  }
+}
+
+size_t GameConfig::getContentHash() const {
+  vector<size_t> hashes;
+  for (auto& dir : dirs)
+    hashDirectory(dir, hashes);
+  return combineHash(hashes);
+}
@@ -54,16 +54,25 @@ class GameConfig {
   GameConfig(vector<DirectoryPath> modDirs);
   template<typename T>
   [[nodiscard]] optional<string> readObject(T& object, GameConfigId id, KeyVerifier* keyVerifier) const {
-    vector<FilePath> paths;
-    string fileName = getConfigName(id) + ".txt"_s;
-    for (auto& dir : dirs) {
-      auto path = dir.file(fileName);
-      if (path.exists())
-        paths.push_back(std::move(path));
-    }
-    return PrettyPrinting::parseObject<T>(object, paths, keyVerifier);
+    return PrettyPrinting::parseObject<T>(object, getInput(id, keyVerifier));
   }
 
+  // Starts reading and preprocessing all config files on worker threads. The objects are still
+  // deserialized by readObject in the caller's order, so ContentId interning and key verification
+  // don't need to be thread-safe and stay deterministic.
+  void preloadFiles(KeyVerifier*) const;
+  // Waits for the worker threads and releases the files that weren't read.
+  void clearPreloadedFiles() const;
+
   static const char* getConfigName(GameConfigId);
+  // Hash of the names, sizes and modification times of all files in the config directories, used to
+  // validate cached parsing results without reading the files.
+  size_t getContentHash() const;
   vector<DirectoryPath> dirs;
+
+  private:
+  vector<FilePath> getPaths(GameConfigId) const;
+  PrettyPrinting::PreparedInput getInput(GameConfigId, KeyVerifier*) const;
+  struct Preloaded;
+  mutable shared_ptr<Preloaded> preloaded;
 };
@@ -42,25 +42,28 @@ SERIALIZATION_CONSTRUCTOR_IMPL(Immigration)
 
 static HashMap<AttractionType, int> empty;
 
-int Immigration::getAttractionOccupation(const AttractionType& type) const {
+HashMap<AttractionType, int> Immigration::computeAttractionOccupation() const {
   EntitySet<Creature> existing;
   for (Creature* c : collective->getCreatures())
     existing.insert(c);
-  int res = 0;
+  HashMap<AttractionType, int> res;
   for (auto& elem : generated) {
     for (auto c : elem.second)
       if (immigrants[elem.first].getTraits().contains(MinionTrait::INCREASE_POPULATION) ||
-          existing.contains(c)) {
-        auto& elems = minionAttraction.getOrElse(c, empty);
-        auto it = elems.find(type);
-        if (it != elems.end())
-          res += it->second;
-      }
+          existing.contains(c))
+        for (auto& occupied : minionAttraction.getOrElse(c, empty))
+          res[occupied.first] += occupied.second;
   }
   return res;
 }
 
-int Immigration::getAttractionValue(const AttractionType& attraction) const {
+int Immigration::getAttractionOccupation(const AttractionType& type) const {
+  if (!attractionOccupation)
+    attractionOccupation = computeAttractionOccupation();
+  return getValueMaybe(*attractionOccupation, type).value_or(0);
+}
+
+int Immigration::computeAttractionValue(const AttractionType& attraction) const {
   return attraction.match(
         [&](FurnitureType type) {
           auto& constructions = collective->getConstructions();
@@ -74,6 +77,33 @@ int Immigration::getAttractionValue(const AttractionType& attraction) const {
   });
 }
 
+int Immigration::getAttractionValue(const AttractionType& attraction) const {
+  // ConstructionMap keeps the furniture counts up to date, so only item counts need caching.
+  if (!attraction.contains<ItemIndex>())
+    return computeAttractionValue(attraction);
+  auto it = itemAttractionValues.find(attraction);
+  if (it == itemAttractionValues.end())
+    it = itemAttractionValues.emplace(attraction, computeAttractionValue(attraction)).first;
+  return it->second;
+}
+
+void Immigration::onItemsChanged() {
+  itemAttractionValues.clear();
+}
+
+void Immigration::onMinionsChanged() {
+  attractionOccupation = none;
+}
+
+void Immigration::checkAttractionLedger() const {
+  if (attractionOccupation) {
+    auto occupation = computeAttractionOccupation();
+    CHECK(occupation == *attractionOccupation) << "Attraction occupation out of date";
+  }
+  for (auto& elem : itemAttractionValues)
+    CHECK(elem.second == computeAttractionValue(elem.first)) << "Item attraction value out of date";
+}
+
 template <typename Visitor>
 static auto visitAttraction(const Immigration& immigration, const AttractionInfo& attraction, Visitor visit) {
   int value = 0;
@@ -277,6 +307,7 @@ void Immigration::occupyAttraction(const Creature* c, const AttractionInfo& attr
       CHECK(nowOccupy <= toOccupy) << nowOccupy << " " << toOccupy;
       toOccupy -= nowOccupy;
       minionAttraction.getOrInit(c)[type] += nowOccupy;
+      onMinionsChanged();
     }
     if (toOccupy == 0)
       break;
@@ -499,6 +530,7 @@ void Immigration::accept(int id, bool withMessage) {
       c->setCombatExperience(2);
     occupyRequirements(c, candidate.immigrantIndex, creatures.size());
     generated[candidate.immigrantIndex].insert(c);
+    onMinionsChanged();
   }
   if (!immigrantInfo.isPersistent())
     rejectIfNonPersistent(id);
@@ -635,6 +667,7 @@ void Immigration::considerRespawningHorses() {
             generated[elem.index()].erase(c);
             generated[elem.index()].insert(added);
             minionAttraction.set(added, minionAttraction.getOrElse(c, empty));
+            onMinionsChanged();
           }
       }
     }
@@ -643,6 +676,8 @@ void Immigration::considerRespawningHorses() {
 
 void Immigration::update() {
   PROFILE
+  if (ledgerCheck.isDue())
+    checkAttractionLedger();
   if (!initialized) {
     initialized = true;
     initializePersistent();
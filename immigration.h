@@ -70,6 +70,8 @@ class Immigration : public OwnedObject<Immigration> {
   int getAttractionOccupation(const AttractionType& attraction) const;
   int getAttractionValue(const AttractionType& attraction) const;
   bool suppliesRecruits(const Collective*) const;
+  void onItemsChanged();
+  void onMinionsChanged();
 
   private:
   EntityMap<Creature, HashMap<AttractionType, int>> SERIAL(minionAttraction);
@@ -95,4 +97,12 @@ class Immigration : public OwnedObject<Immigration> {
   int getNumGeneratedAndCandidates(int index) const;
   vector<ImmigrantInfo> SERIAL(immigrants);
   void considerRespawningHorses();
+  // Item counts of item attractions, dropped when items in the territory change.
+  mutable HashMap<AttractionType, int> itemAttractionValues;
+  // Occupation of all attraction types, dropped when minions join or leave the collective or claim attractions.
+  mutable optional<HashMap<AttractionType, int>> attractionOccupation;
+  HashMap<AttractionType, int> computeAttractionOccupation() const;
+  int computeAttractionValue(const AttractionType&) const;
+  void checkAttractionLedger() const;
+  CacheCheck ledgerCheck;
 };
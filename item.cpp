@@ -70,7 +70,17 @@ void Item::setAttributes(SItemAttributes a) {
   attributes = a;
 }
 
+int Item::getNewAbilityVersion() {
+  static int lastVersion = 0;
+  return ++lastVersion;
+}
+
+int Item::getAbilityVersion() const {
+  return abilityVersion;
+}
+
 void Item::updateAbility(const ContentFactory* factory) {
+  abilityVersion = getNewAbilityVersion();
   abilityInfo.clear();
   for (auto id : attributes->equipedAbility)
     abilityInfo.push_back(ItemAbility { *factory->getCreatures().getSpell(id), none, getUniqueId().getGenericId() });
@@ -70,6 +70,8 @@ class Item : public Renderable, public UniqueEntity<Item>, public OwnedObject<It
   bool effectAppliedWhenThrown() const;
   const optional<CreaturePredicate>& getApplyPredicate() const;
   vector<ItemAbility>& getAbility();
+  // Changes whenever the ability list is rebuilt. Versions are unique among all items.
+  int getAbilityVersion() const;
   void upgrade(vector<PItem>, const ContentFactory*);
 
   ItemClass getClass() const;
@@ -162,6 +164,8 @@ class Item : public Renderable, public UniqueEntity<Item>, public OwnedObject<It
   optional<GlobalTime> SERIAL(timeout);
   vector<ItemAbility> SERIAL(abilityInfo);
   void updateAbility(const ContentFactory*);
+  int abilityVersion = getNewAbilityVersion();
+  static int getNewAbilityVersion();
 };
 
 CEREAL_CLASS_VERSION(Item, 1)
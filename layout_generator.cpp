@@ -247,19 +247,22 @@ bool make(const LayoutGenerators::NoiseMap& g, LayoutCanvas c, RandomGen& r) {
   if (c.area.empty())
     return true;
   auto map = genNoiseMap(r, c.area, NoiseInit { 1, 1, 1, 1, 1 }, g.exponent);
-  vector<double> all;
-  auto getValue = [&all](double r) {
-    int index = max(0, int(r * all.size()));
-    if (index >= all.size())
-      return all.back() + 1;
-    return all[index];
-  };
-  for (auto v : map.getBounds())
-    all.push_back(map[v]);
-  sort(all.begin(), all.end());
+  int numValues = c.area.width() * c.area.height();
+  vector<int> indices;
   for (auto& generator : g.generators) {
-    auto lower = getValue(generator.lower);
-    auto upper = getValue(generator.upper);
+    indices.push_back(max(0, int(generator.lower * numValues)));
+    indices.push_back(max(0, int(generator.upper * numValues)));
+  }
+  auto cutOffs = getSortedValues(map, indices.transform([&](int index) { return min(index, numValues - 1); }));
+  auto getValue = [&](int i) {
+    if (indices[i] >= numValues)
+      return cutOffs[i] + 1;
+    return cutOffs[i];
+  };
+  for (int i : All(g.generators)) {
+    auto& generator = g.generators[i];
+    auto lower = getValue(2 * i);
+    auto upper = getValue(2 * i + 1);
     for (auto v : c.area)
       if (map[v] >= lower && map[v] < upper)
         if (!generator.generator->make(c.with(Rectangle(v, v + Vec2(1, 1))), r))
@@ -335,37 +338,64 @@ const LayoutGenerators::Connect::Elem* getConnectorElem(const LayoutGenerators::
   return ret;
 }
 
-bool connect(const LayoutGenerators::Connect& g, LayoutCanvas c, RandomGen& r, Vec2 p1, Vec2 p2) {
-  ShortestPath path(c.area,
-      [&](Vec2 pos) {
-        auto elem = getConnectorElem(g, c, r, pos);
-        return !elem ? 1 : elem->cost.value_or(ShortestPath::infinity); },
-      [p2] (Vec2 to) { return p2.dist4(to); },
-      Vec2::directions4(), p1, p2);
-  for (Vec2 v = p2; v != p1; v = path.getNextMove(v)) {
+static double getConnectorCost(const LayoutGenerators::Connect& g, LayoutCanvas c, RandomGen& r, Vec2 pos) {
+  auto elem = getConnectorElem(g, c, r, pos);
+  return !elem ? 1 : elem->cost.value_or(ShortestPath::infinity);
+}
+
+static bool connectToTree(const LayoutGenerators::Connect& g, LayoutCanvas c, RandomGen& r, ConnectSearch& search,
+    Vec2 target) {
+  auto path = search.connect(target, [&](Vec2 pos) { return getConnectorCost(g, c, r, pos); }, Vec2::directions4());
+  ++getConnectStats().numSearches;
+  if (!path)
+    return false;
+  for (auto v : *path) {
     if (auto elem = getConnectorElem(g, c, r, v)) {
       CHECK(!!elem->cost);
       if (!elem->generator->make(c.with(Rectangle(v, v + Vec2(1, 1))), r))
         return false;
     }
+    search.addToTree(v);
   }
   return true;
 }
 
 bool make(const LayoutGenerators::Connect& g, LayoutCanvas c, RandomGen& r) {
+  auto begin = std::chrono::steady_clock::now();
   vector<Vec2> points = c.area.getAllSquares().filter(
       [&](Vec2 v) { return g.toConnect.apply(c.map, v, r); });
-  Vec2 p1;
-  if (!points.empty())
-    for (int i : Range(300)) {
-      p1 = r.choose(points);
-      auto p2 = r.choose(points);
-      if (p1 != p2 && !connect(g, c, r, p1, p2))
+  if (points.empty())
+    return true;
+  // The buffers are shared between calls, unless a Connect is nested in one of the elem generators.
+  static ConnectSearch sharedSearch;
+  static bool sharedSearchUsed = false;
+  ConnectSearch nestedSearch;
+  auto& search = sharedSearchUsed ? nestedSearch : sharedSearch;
+  bool wasUsed = sharedSearchUsed;
+  sharedSearchUsed = true;
+  OnExit onExit([&] {
+    sharedSearchUsed = wasUsed;
+    getConnectStats().millis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  });
+  auto isFree = [&](Vec2 v) { return !getConnectorElem(g, c, r, v); };
+  search.reset(c.area);
+  auto targets = r.permutation(std::move(points));
+  search.addToTree(targets[0]);
+  search.growTree(isFree, Vec2::directions4());
+  for (auto target : targets)
+    if (!search.isInTree(target)) {
+      if (!connectToTree(g, c, r, search, target))
         return false;
+      search.growTree(isFree, Vec2::directions4());
     }
   return true;
 }
 
+ConnectStats& getConnectStats() {
+  static ConnectStats ret;
+  return ret;
+}
+
 bool make(const LayoutGenerators::FloodFill& g, LayoutCanvas c, RandomGen& r) {
   queue<Vec2> q;
   auto wholeArea = c.map->elems.getBounds();
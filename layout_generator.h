@@ -211,3 +211,11 @@ struct LayoutGenerator : LayoutGenerators::GeneratorImpl {
   using GeneratorImpl::GeneratorImpl;
   [[nodiscard]] bool make(LayoutCanvas, RandomGen&) const;
 };
+
+struct ConnectStats {
+  int numSearches = 0;
+  double millis = 0;
+};
+
+/** Number of searches made by Connect generators and total time spent in them, for the layout generation tool.*/
+ConnectStats& getConnectStats();
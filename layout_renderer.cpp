@@ -95,6 +95,12 @@ void generateMapLayout(const MainLoop& mainLoop, const string& layoutName, FileP
   USER_CHECK(factory.randomLayouts.count(RandomLayoutId(layoutName.data()))) << "Layout not found: " << layoutName;
   auto generator = factory.randomLayouts.at(RandomLayoutId(layoutName.data()));
   LayoutCanvas::Map map{ Table<vector<Token>>(layoutSize) };
+  getConnectStats() = ConnectStats{};
+  auto begin = std::chrono::steady_clock::now();
   USER_CHECK(!!generator.make(LayoutCanvas{map.elems.getBounds(), &map}, Random)) << "Generation failed";
+  auto millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
   renderAscii(map, glyphFile);
+  auto& connectStats = getConnectStats();
+  std::cerr << "Generated in " << millis << " ms, connect searches: " << connectStats.numSearches << " in "
+      << connectStats.millis << " ms" << std::endl;
 }
@@ -41,6 +41,7 @@
 #include "collective.h"
 #include "phylactery_info.h"
 #include "content_factory.h"
+#include "tile_gas.h"
 #include "monster_ai.h"
 #include "furniture_layer.h"
 #include "known_tiles.h"
@@ -75,6 +76,15 @@ void Level::serialize(Archive& ar, const unsigned int version) {
       table = std::move(elem.second);
     }
   // ar(furnitureEffects)
+  if (version >= 2)
+    ar(tileGas);
+  else if (Archive::is_loading::value) {
+    *tileGas = TileGas(squares->getBounds());
+    for (auto v : squares->getBounds())
+      if (auto& square = squares->modified[v])
+        if (auto gas = square->takeLegacyGas())
+          tileGas->addLegacyAmounts(v, *gas);
+  }
   if (Archive::is_loading::value) {
     // some code requires these Sectors to be always initialized
     getSectors({MovementTrait::WALK});
@@ -136,8 +146,10 @@ Level::Level(Private, SquareArray s, FurnitureArray f, Model* m, Table<double> s
 }
 
 PLevel Level::create(SquareArray s, FurnitureArray f, Model* m,
-    Table<double> sun, LevelId id, Table<bool> covered, Table<bool> unavailable, const ContentFactory* factory) {
+    Table<double> sun, LevelId id, Table<bool> covered, Table<bool> unavailable, TileGas gas,
+    const ContentFactory* factory) {
   auto ret = makeOwner<Level>(Private{}, std::move(s), std::move(f), m, sun, id);
+  *ret->tileGas = std::move(gas);
   for (Vec2 pos : ret->squares->getBounds()) {
     auto square = ret->squares->getReadonly(pos);
     square->onAddedToLevel(Position(pos, ret.get()));
@@ -576,10 +588,46 @@ void Level::addBurningFurniture(Vec2 pos, FurnitureLayer layer) {
   burningFurniture.insert(make_pair(pos, layer));
 }
 
+void Level::updateFire() {
+  PROFILE;
+  // All burning furniture is updated first, and the fire damage it deals is applied afterwards, so that
+  // furniture that catches fire starts burning in the next tick. Changes to the squares' onFire flags are
+  // collected during both steps and each affected square is updated once at the end.
+  fireMovementUpdates = vector<Vec2>();
+  vector<pair<Vec2, FurnitureLayer>> burning(burningFurniture.begin(), burningFurniture.end());
+  vector<pair<Position, int>> fireDamage;
+  for (auto& elem : burning)
+    if (auto f = furniture->getBuilt(elem.second).getWritable(elem.first))
+      f->updateFire(Position(elem.first, this), elem.second, fireDamage);
+  for (auto& elem : fireDamage)
+    elem.first.fireDamage(elem.second);
+  vector<Vec2> updates;
+  for (auto v : *fireMovementUpdates) {
+    updates.push_back(v);
+    for (auto neighbor : v.neighbors8())
+      if (neighbor.inRectangle(getBounds()))
+        updates.push_back(neighbor);
+  }
+  fireMovementUpdates = none;
+  sort(updates.begin(), updates.end());
+  for (int i : All(updates))
+    if (i == 0 || updates[i] != updates[i - 1])
+      Position(updates[i], this).updateOnFire();
+  for (auto& elem : burning) {
+    auto f = furniture->getBuilt(elem.second).getReadonly(elem.first);
+    if (!f || !((f->getFire() && f->getFire()->isBurning()) || f->hasBlood()))
+      burningFurniture.erase(elem);
+  }
+}
+
 void Level::tick() {
   PROFILE_BLOCK("Level::tick");
-  for (Vec2 pos : tickingSquares)
-    squares->getWritable(pos)->tick(Position(pos, this));
+  for (auto it = tickingSquares.begin(); it != tickingSquares.end();)
+    if (squares->getWritable(*it)->tick(Position(*it, this)))
+      ++it;
+    else
+      it = tickingSquares.erase(it);
+  tileGas->tick(this);
   auto& furnitureFactory = getGame()->getContentFactory()->furniture;
   for (auto& elem : tickingFurniture)
     if (auto f = furniture->getBuilt(elem.first.second).getWritable(elem.first.first)) {
@@ -593,9 +641,7 @@ void Level::tick() {
       if (Random.chance(chance))
         f->tick(Position(elem.first.first, this), elem.first.second);
     }
-  for (auto& elem : burningFurniture)
-    if (auto f = furniture->getBuilt(std::get<1>(elem)).getWritable(std::get<0>(elem)))
-      f->updateFire(Position(std::get<0>(elem), this), std::get<1>(elem));
+  updateFire();
   addedWildlife = addedWildlife.filter([this, col = getGame()->getPlayerCollective()](Creature* c) {
     return c->getPosition().getLevel() == this && (!col || !col->getCreatures().contains(c)); });
   if (Random.roll(50) && addedWildlife.size() < wildlife.count.getStart()) {
@@ -610,27 +656,41 @@ void Level::tick() {
         addedWildlife.push_back(ref);
     }
   }
-  if (above) {
-    PROFILE_BLOCK("Z level tick");
-    for (auto v : getBounds()) {
-      if (!unavailable[v] && above->unavailable[v]) {
-        Position pos(v, this);
-        if (pos.isCovered()) {
-          Position abovePos(v, above);
-          auto col = getGame()->getPlayerCollective();
-          above->unavailable[v] = false;
-          abovePos.addFurniture(getGame()->getContentFactory()->furniture.getFurniture(FurnitureType("ROOF"),
-              TribeId::getMonster()));
-          if (!!col && col->getKnownTiles().isKnown(pos)) {
-            col->addKnownTile(abovePos);
-            getGame()->getPlayerControl()->addToMemory(abovePos);
-          }
-          if (!!col && col->getTerritory().contains(pos))
-            col->claimSquare(abovePos);
+  if (above)
+    updateRoofs();
+}
+
+void Level::addRoofCandidate(Vec2 pos, FurnitureLayer layer) {
+  if (above && (layer == FurnitureLayer::GROUND || layer == FurnitureLayer::MIDDLE))
+    roofCandidates.push_back(pos);
+}
+
+void Level::updateRoofs() {
+  PROFILE_BLOCK("Z level tick");
+  vector<Vec2> candidates;
+  if (above != roofScanAbove) {
+    roofScanAbove = above;
+    candidates = getBounds().getAllSquares();
+    roofCandidates.clear();
+  } else
+    swap(candidates, roofCandidates);
+  for (auto v : candidates)
+    if (!unavailable[v] && above->unavailable[v]) {
+      Position pos(v, this);
+      if (pos.isCovered()) {
+        Position abovePos(v, above);
+        auto col = getGame()->getPlayerCollective();
+        above->unavailable[v] = false;
+        abovePos.addFurniture(getGame()->getContentFactory()->furniture.getFurniture(FurnitureType("ROOF"),
+            TribeId::getMonster()));
+        if (!!col && col->getKnownTiles().isKnown(pos)) {
+          col->addKnownTile(abovePos);
+          getGame()->getPlayerControl()->addToMemory(abovePos);
         }
+        if (!!col && col->getTerritory().contains(pos))
+          col->claimSquare(abovePos);
       }
     }
-  }
 }
 
 bool Level::inBounds(Vec2 pos) const {
@@ -715,6 +775,7 @@ bool Level::needsMemoryUpdate(Vec2 pos) const {
 
 void Level::setFurniture(Vec2 pos, PFurniture f) {
   auto layer = f->getLayer();
+  addRoofCandidate(pos, layer);
   furniture->eraseConstruction(pos, layer);
   if (f->isTicking())
     addTickingFurniture(pos, f->getLayer());
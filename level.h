@@ -37,6 +37,7 @@ class Sectors;
 class Tribe;
 class Attack;
 class PlayerMessage;
+class TileGas;
 class CreatureBucketMap;
 class Position;
 class Game;
@@ -185,8 +186,18 @@ class Level : public OwnedObject<Level> {
   Table<bool> SERIAL(unavailable);
   LandingSquares SERIAL(landingSquares);
   set<Vec2> SERIAL(tickingSquares);
+  // Squares whose ground or middle furniture changed, which may now need a roof on the level above.
+  vector<Vec2> roofCandidates;
+  // The level above at the time of the last full roof scan. A new level above requires scanning all squares again.
+  Level* roofScanAbove = nullptr;
+  void addRoofCandidate(Vec2, FurnitureLayer);
+  void updateRoofs();
+  HeapAllocated<TileGas> SERIAL(tileGas);
   HashMap<pair<Vec2, FurnitureLayer>, double> tickingFurniture;
   HashSet<pair<Vec2, FurnitureLayer>> burningFurniture;
+  // Squares whose onFire flag needs to be updated, collected while burning furniture is updated.
+  optional<vector<Vec2>> fireMovementUpdates;
+  void updateFire();
   void placeCreature(Creature*, Vec2 pos);
   void unplaceCreature(Creature*, Vec2 pos);
   vector<Creature*> SERIAL(creatures);
@@ -207,7 +218,7 @@ class Level : public OwnedObject<Level> {
   struct Private {};
 
   static PLevel create(SquareArray s, FurnitureArray f, Model* m, Table<double> sun, LevelId id,
-      Table<bool> cover, Table<bool> unavailable, const ContentFactory*);
+      Table<bool> cover, Table<bool> unavailable, TileGas, const ContentFactory*);
 
   public:
   Level(Private, SquareArray, FurnitureArray, Model*, Table<double> sunlight, LevelId);
@@ -228,4 +239,4 @@ class Level : public OwnedObject<Level> {
   void updateTickingFurniture();
 };
 
-CEREAL_CLASS_VERSION(Level, 1)
\ No newline at end of file
+CEREAL_CLASS_VERSION(Level, 2)
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "level_builder.h"
+#include "tile_gas.h"
 #include "progress_meter.h"
 #include "square.h"
 #include "creature.h"
@@ -32,6 +33,38 @@ LevelBuilder::~LevelBuilder() {}
 
 LevelBuilder::LevelBuilder(LevelBuilder&&) = default;
 
+template <typename Fun>
+void LevelBuilder::addUndo(Fun fun) {
+  ++modCount;
+  if (numCheckpoints > 0)
+    undoLog.push_back(std::move(fun));
+}
+
+int LevelBuilder::getModCount() const {
+  return modCount;
+}
+
+int LevelBuilder::checkpoint() {
+  ++numCheckpoints;
+  return undoLog.size();
+}
+
+void LevelBuilder::rollback(int checkpoint) {
+  CHECK(numCheckpoints > 0);
+  while (undoLog.size() > checkpoint) {
+    undoLog.back()();
+    undoLog.pop_back();
+  }
+  ++modCount;
+  --numCheckpoints;
+}
+
+void LevelBuilder::commit(int checkpoint) {
+  CHECK(numCheckpoints > 0);
+  if (--numCheckpoints == 0)
+    undoLog.clear();
+}
+
 RandomGen& LevelBuilder::getRandom() {
   return random;
 }
@@ -45,16 +78,16 @@ bool LevelBuilder::hasAttrib(Vec2 posT, SquareAttrib attr) {
   return attrib[pos].contains(attr);
 }
 
-void LevelBuilder::addAttrib(Vec2 pos, SquareAttrib attr) {
-  attrib[transform(pos)].insert(attr);
-}
-
-void LevelBuilder::removeAttrib(Vec2 pos, SquareAttrib attr) {
-  attrib[transform(pos)].erase(attr);
+void LevelBuilder::addAttrib(Vec2 posT, SquareAttrib attr) {
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, prev = attrib[pos]] { attrib[pos] = prev; });
+  attrib[pos].insert(attr);
 }
 
-Square* LevelBuilder::modSquare(Vec2 pos) {
-  return squares.getWritable(transform(pos));
+void LevelBuilder::removeAttrib(Vec2 posT, SquareAttrib attr) {
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, prev = attrib[pos]] { attrib[pos] = prev; });
+  attrib[pos].erase(attr);
 }
 
 Rectangle LevelBuilder::toGlobalCoordinates(Rectangle area) {
@@ -66,12 +99,16 @@ vector<Vec2> LevelBuilder::toGlobalCoordinates(const vector<Vec2>& v) {
 }
 
 void LevelBuilder::addCollective(CollectiveBuilder* col) {
-  if (!collectives.contains(col))
+  if (!collectives.contains(col)) {
     collectives.push_back(col);
+    addUndo([this] { collectives.pop_back(); });
+  }
 }
 
-void LevelBuilder::setHeightMap(Vec2 pos, double h) {
-  heightMap[transform(pos)] = h;
+void LevelBuilder::setHeightMap(Vec2 posT, double h) {
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, prev = heightMap[pos]] { heightMap[pos] = prev; });
+  heightMap[pos] = h;
 }
 
 double LevelBuilder::getHeightMap(Vec2 pos) {
@@ -80,11 +117,13 @@ double LevelBuilder::getHeightMap(Vec2 pos) {
 
 void LevelBuilder::putCreature(Vec2 pos, PCreature creature) {
   creatures.emplace_back(std::move(creature), transform(pos));
+  addUndo([this] { creatures.pop_back(); });
 }
 
 void LevelBuilder::putItems(Vec2 posT, vector<PItem> it) {
   CHECK(canPutItems(posT));
   Vec2 pos = transform(posT);
+  addUndo([this, pos, prevSize = items[pos].size()] { items[pos].resize(prevSize); });
   append(items[pos], std::move(it));
 }
 
@@ -105,7 +144,10 @@ void LevelBuilder::putFurniture(Vec2 posT, FurnitureParams f, optional<SquareAtt
   auto layer = contentFactory->furniture.getData(f.type).getLayer();
   if (getFurniture(posT, layer))
     removeFurniture(posT, layer);
-  furniture.getBuilt(layer).putElem(transform(posT), f, [&](const FurnitureParams& t) {
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, layer, prev = furniture.getBuilt(layer).getSlot(pos)] {
+      furniture.getBuilt(layer).setSlot(pos, prev); });
+  furniture.getBuilt(layer).putElem(pos, f, [&](const FurnitureParams& t) {
     return contentFactory->furniture.getFurniture(t.type, t.tribe); });
   if (attrib)
     addAttrib(posT, *attrib);
@@ -136,9 +178,12 @@ bool LevelBuilder::canPutFurniture(Vec2 posT, FurnitureLayer layer) {
   return !getFurniture(posT, layer);
 }
 
-void LevelBuilder::removeFurniture(Vec2 pos, FurnitureLayer layer) {
-  CHECK(getFurnitureType(pos, layer) != FurnitureType("DOWN_STAIRS"));
-  furniture.getBuilt(layer).clearElem(transform(pos));
+void LevelBuilder::removeFurniture(Vec2 posT, FurnitureLayer layer) {
+  CHECK(getFurnitureType(posT, layer) != FurnitureType("DOWN_STAIRS"));
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, layer, prev = furniture.getBuilt(layer).getSlot(pos)] {
+      furniture.getBuilt(layer).setSlot(pos, prev); });
+  furniture.getBuilt(layer).clearElem(pos);
 }
 
 void LevelBuilder::removeAllFurniture(Vec2 pos) {
@@ -163,6 +208,10 @@ const Furniture* LevelBuilder::getFurniture(Vec2 posT, FurnitureLayer layer) {
 
 void LevelBuilder::setLandingLink(Vec2 posT, StairKey key) {
   Vec2 pos = transform(posT);
+  if (auto& square = squares.modified[pos])
+    addUndo([this, pos, prev = square->getLandingLink()] { squares.modified[pos]->setLandingLink(prev); });
+  else
+    addUndo([this, pos] { squares.modified[pos].reset(); --squares.numModified; });
   squares.getWritable(pos)->setLandingLink(key);
 }
 
@@ -178,6 +227,7 @@ bool LevelBuilder::canPutCreature(Vec2 posT, Creature* c) {
 }
 
 void LevelBuilder::setNoDiagonalPassing() {
+  addUndo([this, prev = noDiagonalPassing] { noDiagonalPassing = prev; });
   noDiagonalPassing = true;
 }
 
@@ -189,9 +239,11 @@ PLevel LevelBuilder::build(const ContentFactory* factory, Model* m, LevelMaker*
   for (Vec2 v : squares.getBounds())
     if (!items[v].empty())
       squares.getWritable(v)->dropItemsLevelGen(std::move(items[v]));
+  TileGas gas(squares.getBounds());
   for (auto& elem : permanentGas)
-    squares.getWritable(elem.second)->addPermanentGas(elem.first, 1);
-  auto l = Level::create(std::move(squares), std::move(furniture), m, sunlight, levelId, covered, unavailable, factory);
+    gas.addPermanentAmount(elem.second, elem.first, 1);
+  auto l = Level::create(std::move(squares), std::move(furniture), m, sunlight, levelId, covered, unavailable,
+      std::move(gas), factory);
   for (pair<PCreature, Vec2>& c : creatures) {
     Position pos(c.second, l.get());
     /*CHECK(pos.canEnter(c.first.get())) << c.first->getName().bare();
@@ -240,9 +292,11 @@ void LevelBuilder::pushMap(Rectangle bounds, Rot rot) {
     case CW2: mapStack.push_back(deg180(bounds)); break;
     case CW3: mapStack.push_back(deg270(bounds)); break;
   }
+  addUndo([this] { mapStack.pop_back(); });
 }
 
 void LevelBuilder::popMap() {
+  addUndo([this, prev = mapStack.back()] { mapStack.push_back(prev); });
   mapStack.pop_back();
 }
 
@@ -254,25 +308,33 @@ Vec2 LevelBuilder::transform(Vec2 v) {
 }
 
 void LevelBuilder::setCovered(Vec2 posT, bool state) {
-  covered[transform(posT)] = state;
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, prev = covered[pos]] { covered[pos] = prev; });
+  covered[pos] = state;
 }
 
 void LevelBuilder::setSunlight(Vec2 pos, double s) {
+  addUndo([this, pos, prev = sunlight[pos]] { sunlight[pos] = prev; });
   sunlight[pos] = s;
 }
 
 void LevelBuilder::addPermanentGas(TileGasType type, Vec2 posT) {
   permanentGas.push_back({type, transform(posT)});
+  addUndo([this] { permanentGas.pop_back(); });
 }
 
 void LevelBuilder::setMountainLevel(Vec2 posT, int level) {
   if (mountainLevel.getHeight() == 0)
     mountainLevel = Table<int>(covered.getBounds(), 0);
-  mountainLevel[transform(posT)] = level;
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, prev = mountainLevel[pos]] { mountainLevel[pos] = prev; });
+  mountainLevel[pos] = level;
 }
 
-void LevelBuilder::setUnavailable(Vec2 pos) {
-  unavailable[transform(pos)] = true;
+void LevelBuilder::setUnavailable(Vec2 posT) {
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, prev = unavailable[pos]] { unavailable[pos] = prev; });
+  unavailable[pos] = true;
 }
 
 bool LevelBuilder::canNavigate(Vec2 posT, const MovementType& movement) {
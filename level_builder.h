@@ -27,9 +27,6 @@ class LevelBuilder {
   LevelBuilder(LevelBuilder&&);
   ~LevelBuilder();
 
-  /** Returns a given square.*/
-  Square* modSquare(Vec2);
-
   /** Checks if it's possible to put a creature on given square.*/
   bool canPutCreature(Vec2, Creature*);
 
@@ -104,6 +101,19 @@ class LevelBuilder {
   void pushMap(Rectangle bounds, Rot);
   void popMap();
 
+  /** Starts recording changes, so that they can be undone. Returns a handle to pass to rollback() or commit().
+      Checkpoints can be nested.*/
+  int checkpoint();
+
+  /** Undoes all changes made since the given checkpoint and ends it.*/
+  void rollback(int checkpoint);
+
+  /** Ends the given checkpoint, keeping the changes.*/
+  void commit(int checkpoint);
+
+  /** Returns a counter that changes whenever the level is modified. Used to invalidate cached results.*/
+  int getModCount() const;
+
   RandomGen& getRandom();
   ContentFactory* getContentFactory() const;
 
@@ -111,6 +121,11 @@ class LevelBuilder {
 
   private:
   Vec2 transform(Vec2);
+  template <typename Fun>
+  void addUndo(Fun);
+  vector<function<void()>> undoLog;
+  int numCheckpoints = 0;
+  int modCount = 0;
   SquareArray squares;
   Table<bool> unavailable;
   Table<double> heightMap;
@@ -19,6 +19,7 @@
 #include "item_factory.h"
 #include "square.h"
 #include "collective_builder.h"
+#include "collective_config.h"
 #include "collective.h"
 #include "shortest_path.h"
 #include "creature.h"
@@ -65,6 +66,124 @@ void checkGen(bool b) {
     failGen();
 }
 
+// Values of a predicate over a rectangle, one bit per square.
+class PredicateMask {
+  public:
+  PredicateMask(Rectangle area) : area(area), rowWords((area.width() + 63) / 64), bits(rowWords * area.height(), 0) {}
+
+  bool get(Vec2 v) const {
+    v -= area.topLeft();
+    return (bits[v.y * rowWords + v.x / 64] >> (v.x % 64)) & 1;
+  }
+
+  void set(Vec2 v) {
+    v -= area.topLeft();
+    bits[v.y * rowWords + v.x / 64] |= uint64_t(1) << (v.x % 64);
+  }
+
+  PredicateMask& operator &= (const PredicateMask& o) {
+    for (int i : All(bits))
+      bits[i] &= o.bits[i];
+    return *this;
+  }
+
+  PredicateMask& operator |= (const PredicateMask& o) {
+    for (int i : All(bits))
+      bits[i] |= o.bits[i];
+    return *this;
+  }
+
+  void invert() {
+    uint64_t lastWordMask = area.width() % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (area.width() % 64)) - 1;
+    for (int i : All(bits)) {
+      bits[i] = ~bits[i];
+      if (i % rowWords == rowWords - 1)
+        bits[i] &= lastWordMask;
+    }
+  }
+
+  const Rectangle& getArea() const {
+    return area;
+  }
+
+  private:
+  Rectangle area;
+  int rowWords;
+  vector<uint64_t> bits;
+};
+
+class PredicatePrecalc {
+  public:
+  PredicatePrecalc(const PredicateMask& mask)
+      : counts(Rectangle(mask.getArea().topLeft(), mask.getArea().bottomRight() + Vec2(1, 1))) {
+    auto& area = mask.getArea();
+    int px = counts.getBounds().left();
+    int py = counts.getBounds().top();
+    for (int x : Range(px, counts.getBounds().right()))
+      counts[x][py] = 0;
+    for (int y : Range(py, counts.getBounds().bottom()))
+      counts[px][y] = 0;
+    for (Vec2 v : Rectangle(area.topLeft() + Vec2(1, 1), counts.getBounds().bottomRight()))
+      counts[v] = (mask.get(v - Vec2(1, 1)) ? 1 : 0) +
+        counts[v.x - 1][v.y] + counts[v.x][v.y - 1] -counts[v.x - 1][v.y - 1];
+  }
+
+  int getCount(Rectangle area) const {
+    return counts[area.bottomRight()] + counts[area.topLeft()]
+      -counts[area.bottomLeft()] - counts[area.topRight()];
+  }
+
+  private:
+  Table<int> counts;
+};
+
+// Results of predicates evaluated over one area, keyed by the predicate. Dropped when the level is modified.
+class PredicateCache {
+  public:
+  PredicateCache(LevelBuilder* builder, Rectangle area)
+      : builder(builder), area(area), modCount(builder->getModCount()) {}
+
+  LevelBuilder* getBuilder() const {
+    return builder;
+  }
+
+  const Rectangle& getArea() const {
+    return area;
+  }
+
+  template <typename Fun>
+  const PredicateMask& getMask(const string& key, Fun evaluate) {
+    validate();
+    if (!masks.count(key))
+      masks.insert(make_pair(key, evaluate()));
+    return masks.at(key);
+  }
+
+  template <typename Fun>
+  shared_ptr<const PredicatePrecalc> getPrecalc(const string& key, Fun evaluate) {
+    validate();
+    auto& ret = precalcs[key];
+    if (!ret)
+      ret = make_shared<PredicatePrecalc>(evaluate());
+    return ret;
+  }
+
+  private:
+  void validate() {
+    if (builder->getModCount() != modCount) {
+      masks.clear();
+      precalcs.clear();
+      modCount = builder->getModCount();
+    }
+  }
+
+  LevelBuilder* builder;
+  Rectangle area;
+  int modCount;
+  unordered_map<string, PredicateMask> masks;
+  unordered_map<string, shared_ptr<const PredicatePrecalc>> precalcs;
+};
+
 class Predicate {
   public:
   bool apply(LevelBuilder* builder, Vec2 pos) const {
@@ -81,51 +200,92 @@ class Predicate {
     return builder->getRandom().choose(good);
   }
 
+  /** Evaluates the predicate over the cache's area. Composite predicates combine the masks of their operands,
+      so every distinct predicate is evaluated only once per square.*/
+  PredicateMask getMask(PredicateCache& cache) const {
+    auto evaluate = [&] {
+      if (maskFun)
+        return maskFun(cache);
+      PredicateMask ret(cache.getArea());
+      for (Vec2 v : cache.getArea())
+        if (apply(cache.getBuilder(), v))
+          ret.set(v);
+      return ret;
+    };
+    if (key.empty())
+      return evaluate();
+    return cache.getMask(key, evaluate);
+  }
+
+  shared_ptr<const PredicatePrecalc> getPrecalc(PredicateCache& cache) const {
+    auto evaluate = [&] { return PredicatePrecalc(getMask(cache)); };
+    if (key.empty())
+      return make_shared<PredicatePrecalc>(evaluate());
+    return cache.getPrecalc(key, evaluate);
+  }
+
   static Predicate attrib(SquareAttrib attr) {
-    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return builder->hasAttrib(pos, attr);});
+    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return builder->hasAttrib(pos, attr);},
+        "attrib "_s + EnumInfo<SquareAttrib>::getString(attr));
   }
 
   static Predicate hasAnyItems() {
-    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return builder->hasAnyItems(pos);});
+    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return builder->hasAnyItems(pos);}, "hasAnyItems");
   }
 
   Predicate operator !() const {
     PredFun self(predFun);
-    return Predicate([self] (LevelBuilder* builder, Vec2 pos) { return !self(builder, pos);});
+    Predicate copy(*this);
+    return Predicate([self] (LevelBuilder* builder, Vec2 pos) { return !self(builder, pos);},
+        [copy] (PredicateCache& cache) { auto ret = copy.getMask(cache); ret.invert(); return ret; },
+        combineKeys("!", {key}));
   }
 
   Predicate operator && (const Predicate& p1) const {
     PredFun self(predFun);
+    Predicate copy(*this);
     return Predicate([self, p1] (LevelBuilder* builder, Vec2 pos) {
-        return p1.apply(builder, pos) && self(builder, pos);});
+        return p1.apply(builder, pos) && self(builder, pos);},
+        [copy, p1] (PredicateCache& cache) { auto ret = copy.getMask(cache); ret &= p1.getMask(cache); return ret; },
+        combineKeys("&&", {key, p1.key}));
   }
 
   Predicate operator || (const Predicate& p1) const {
     PredFun self(predFun);
+    Predicate copy(*this);
     return Predicate([=] (LevelBuilder* builder, Vec2 pos) {
-        return p1.apply(builder, pos) || self(builder, pos);});
+        return p1.apply(builder, pos) || self(builder, pos);},
+        [copy, p1] (PredicateCache& cache) { auto ret = copy.getMask(cache); ret |= p1.getMask(cache); return ret; },
+        combineKeys("||", {key, p1.key}));
   }
 
   static Predicate type(FurnitureType t) {
     return Predicate([=] (LevelBuilder* builder, Vec2 pos) {
-      return builder->isFurnitureType(pos, t);});
+      return builder->isFurnitureType(pos, t);}, "type "_s + t.data());
   }
 
   static Predicate inRectangle(Rectangle r) {
     return Predicate([=] (LevelBuilder* builder, Vec2 pos) {
-      return pos.inRectangle(r);});
+      return pos.inRectangle(r);}, "inRectangle " + toString(r));
   }
 
   static Predicate alwaysTrue() {
-    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return true;});
+    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return true;}, "true");
   }
 
   static Predicate alwaysFalse() {
-    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return false;});
+    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return false;}, "false");
   }
 
   static Predicate canEnter(MovementType m) {
-    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return builder->canNavigate(pos, m);});
+    string key;
+    // Only plain movement types are identified by their traits.
+    if (m == MovementType(m.getTraits())) {
+      key = "canEnter";
+      for (auto trait : m.getTraits())
+        key += " "_s + EnumInfo<MovementTrait>::getString(trait);
+    }
+    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return builder->canNavigate(pos, m);}, key);
   }
 
   static Predicate near8AtLeast(FurnitureType type, int count) {
@@ -135,7 +295,7 @@ class Predicate {
         if (builder->isFurnitureType(v, type))
           --cnt;
       return cnt <= 0;
-    });
+    }, "near8AtLeast "_s + type.data() + " " + toString(count));
   }
 
   static Predicate near4AtLeast(FurnitureType type, int count) {
@@ -145,7 +305,7 @@ class Predicate {
         if (builder->isFurnitureType(v, type))
           --cnt;
       return cnt <= 0;
-    });
+    }, "near4AtLeast "_s + type.data() + " " + toString(count));
   }
 
   static Predicate near4Equals(FurnitureType type, int count) {
@@ -155,13 +315,27 @@ class Predicate {
         if (builder->isFurnitureType(v, type))
           --cnt;
       return cnt == 0;
-    });
+    }, "near4Equals "_s + type.data() + " " + toString(count));
   }
 
   private:
   typedef function<bool(LevelBuilder*, Vec2)> PredFun;
-  Predicate(PredFun fun) : predFun(fun) {}
+  typedef function<PredicateMask(PredicateCache&)> MaskFun;
+  Predicate(PredFun fun, string key) : predFun(fun), key(std::move(key)) {}
+  Predicate(PredFun fun, MaskFun maskFun, string key) : predFun(fun), maskFun(maskFun), key(std::move(key)) {}
+
+  static string combineKeys(const string& op, const vector<string>& keys) {
+    for (auto& key : keys)
+      if (key.empty())
+        return "";
+    return op + "(" + combine(keys, true) + ")";
+  }
+
   PredFun predFun;
+  // Combines the masks of the operands, empty for basic predicates.
+  MaskFun maskFun;
+  // Predicates with equal keys give equal results. Empty if the predicate can't be identified.
+  string key;
 };
 
 class SquareChange {
@@ -393,26 +567,30 @@ class Connector : public LevelMaker {
     return diggingCost;
   }
 
+  void makePassable(LevelBuilder* builder, Vec2 v) {
+    if (!builder->canNavigate(v, {MovementTrait::WALK})) {
+      if (auto furniture = builder->getFurniture(v, FurnitureLayer::MIDDLE)) {
+        bool placeDoor = furniture->isWall() && builder->hasAttrib(v, SquareAttrib::ROOM_WALL);
+        if (!furniture->getMovementSet().canEnter({MovementTrait::WALK}))
+          builder->removeFurniture(v, FurnitureLayer::MIDDLE);
+        if (placeDoor && door && builder->getRandom().chance(door->prob)) {
+          builder->putFurniture(v, door->type, tribe);
+        }
+      }
+      if (!builder->canNavigate(v, {MovementTrait::WALK}))
+        if (auto bridge = builder->getFurniture(v, FurnitureLayer::GROUND)->getDefaultBridge())
+          builder->putFurniture(v, *bridge);
+      CHECK(builder->canNavigate(v, {MovementTrait::WALK}));
+    }
+  }
+
   void connect(LevelBuilder* builder, Vec2 p1, Vec2 p2, Rectangle area) {
     ShortestPath path(area,
         [builder, this, &area](Vec2 pos) { return getValue(builder, pos, area); }, 
         [p2] (Vec2 to) { return p2.dist4(to); },
         Vec2::directions4(builder->getRandom()), p1, p2);
     for (Vec2 v = p2; v != p1; v = path.getNextMove(v)) {
-      if (!builder->canNavigate(v, {MovementTrait::WALK})) {
-        if (auto furniture = builder->getFurniture(v, FurnitureLayer::MIDDLE)) {
-          bool placeDoor = furniture->isWall() && builder->hasAttrib(v, SquareAttrib::ROOM_WALL);
-          if (!furniture->getMovementSet().canEnter({MovementTrait::WALK}))
-            builder->removeFurniture(v, FurnitureLayer::MIDDLE);
-          if (placeDoor && door && builder->getRandom().chance(door->prob)) {
-            builder->putFurniture(v, door->type, tribe);
-          }
-        }
-        if (!builder->canNavigate(v, {MovementTrait::WALK}))
-          if (auto bridge = builder->getFurniture(v, FurnitureLayer::GROUND)->getDefaultBridge())
-            builder->putFurniture(v, *bridge);
-        CHECK(builder->canNavigate(v, {MovementTrait::WALK}));
-      }
+      makePassable(builder, v);
       if (!path.isReachable(v))
         failGen();
     }
@@ -429,31 +607,27 @@ class Connector : public LevelMaker {
       if (p1 != p2)
         connect(builder, p1, p2, area);
     }
-    auto dijkstraFun = [&] (Vec2 pos) {
-      if (builder->canNavigate(pos, MovementTrait::WALK))
-        return 1.;
-      else
-        return ShortestPath::infinity;};
-    Table<bool> connected(area, false);
-    while (1) {
-      Dijkstra dijkstra(area, {p1}, 10000, dijkstraFun);
-      for (Vec2 v : area)
-        if (dijkstra.isReachable(v))
-          connected[v] = true;
-      bool found = false;
-      for (Vec2 v : area)
-        if (connectPred.apply(builder, v) && !connected[v]) {
-          connect(builder, p1, v, area);
-          p1 = v;
-          found = true;
-          break;
-         }
-      if (!found)
-        break;
-    }
+    // Make sure everything is connected by growing a single tree of walkable squares from p1.
+    auto canWalk = [&] (Vec2 pos) { return builder->canNavigate(pos, MovementTrait::WALK); };
+    search.reset(area);
+    search.addToTree(p1);
+    search.growTree(canWalk, Vec2::directions8());
+    for (Vec2 v : points)
+      if (!search.isInTree(v)) {
+        auto path = search.connect(v, [&](Vec2 pos) { return getValue(builder, pos, area); },
+            Vec2::directions4(builder->getRandom()));
+        if (!path)
+          failGen();
+        for (Vec2 pos : *path) {
+          makePassable(builder, pos);
+          search.addToTree(pos);
+        }
+        search.growTree(canWalk, Vec2::directions8());
+      }
   }
   
   private:
+  ConnectSearch search;
   optional<BuildingInfo::DoorInfo> door;
   TribeId tribe;
   double diggingCost;
@@ -1070,28 +1244,36 @@ class MakerQueue : public LevelMaker {
   vector<PLevelMaker> makers;
 };
 
-class PredicatePrecalc {
+class RetryMaker : public LevelMaker {
   public:
-  PredicatePrecalc(const Predicate& predicate, LevelBuilder* builder, Rectangle area)
-      : counts(Rectangle(area.topLeft(), area.bottomRight() + Vec2(1, 1))) {
-    int px = counts.getBounds().left();
-    int py = counts.getBounds().top();
-    for (int x : Range(px, counts.getBounds().right()))
-      counts[x][py] = 0;
-    for (int y : Range(py, counts.getBounds().bottom()))
-      counts[px][y] = 0;
-    for (Vec2 v : Rectangle(area.topLeft() + Vec2(1, 1), counts.getBounds().bottomRight()))
-      counts[v] = (predicate.apply(builder, v - Vec2(1, 1)) ? 1 : 0) +
-        counts[v.x - 1][v.y] + counts[v.x][v.y - 1] -counts[v.x - 1][v.y - 1];
-  }
+  RetryMaker(PLevelMaker maker, string name, CollectiveBuilder* collective, int numTries)
+      : maker(std::move(maker)), name(std::move(name)), collective(collective), numTries(numTries) {}
 
-  int getCount(Rectangle area) const {
-    return counts[area.bottomRight()] + counts[area.topLeft()]
-      -counts[area.bottomLeft()] - counts[area.topRight()];
+  virtual void make(LevelBuilder* builder, Rectangle area) override {
+    auto& stats = getRetryStats()[name];
+    for (int i : Range(numTries)) {
+      ++stats.numTries;
+      auto checkpoint = builder->checkpoint();
+      auto collectiveState = collective ? optional<CollectiveBuilder>(*collective) : none;
+      try {
+        maker->make(builder, area);
+        builder->commit(checkpoint);
+        return;
+      } catch (LevelGenException) {
+        ++stats.numFailures;
+        builder->rollback(checkpoint);
+        if (collectiveState)
+          *collective = *collectiveState;
+      }
+    }
+    failGen();
   }
 
   private:
-  Table<int> counts;
+  PLevelMaker maker;
+  string name;
+  CollectiveBuilder* collective;
+  int numTries;
 };
 
 class RandomLocations : public LevelMaker {
@@ -1118,25 +1300,25 @@ class RandomLocations : public LevelMaker {
 
     class Precomputed {
       public:
-      Precomputed(LevelBuilder* builder, Rectangle area, Predicate p1, Predicate p2, int minSec, int maxSec)
-        : pred1(p1, builder, area), pred2(p2, builder, area), minSecond(minSec), maxSecond(maxSec) {
+      Precomputed(PredicateCache& cache, const Predicate& p1, const Predicate& p2, int minSec, int maxSec)
+        : pred1(p1.getPrecalc(cache)), pred2(p2.getPrecalc(cache)), minSecond(minSec), maxSecond(maxSec) {
       }
 
       bool apply(Rectangle rect) const {
-        int numFirst = pred1.getCount(rect);
-        int numSecond = pred2.getCount(rect);
+        int numFirst = pred1->getCount(rect);
+        int numSecond = pred2->getCount(rect);
         return numSecond >= minSecond && numSecond < maxSecond && numSecond + numFirst == rect.width() * rect.height();
       }
 
       private:
-      PredicatePrecalc pred1;
-      PredicatePrecalc pred2;
+      shared_ptr<const PredicatePrecalc> pred1;
+      shared_ptr<const PredicatePrecalc> pred2;
       int minSecond;
       int maxSecond;
     };
 
-    Precomputed precompute(LevelBuilder* builder, Rectangle area) const {
-      return Precomputed(builder, area, predicate, second, minSecond, maxSecond);
+    Precomputed precompute(PredicateCache& cache) const {
+      return Precomputed(cache, predicate, second, minSecond, maxSecond);
     }
 
     private:
@@ -1194,11 +1376,12 @@ class RandomLocations : public LevelMaker {
     return insideMakers.back().get();
   }
 
-  pair<vector<Vec2>, LevelBuilder::Rot> getAllowedPositions(LevelBuilder* builder, Rectangle area, LevelMaker* maker,
+  pair<vector<Vec2>, LevelBuilder::Rot> getAllowedPositions(PredicateCache& cache, LevelMaker* maker,
       const LocationPredicate& predicate, Vec2 size) {
-    auto rotation = builder->getRandom().choose(
+    auto area = cache.getArea();
+    auto rotation = cache.getBuilder()->getRandom().choose(
           LevelBuilder::CW0, LevelBuilder::CW1, LevelBuilder::CW2, LevelBuilder::CW3);
-    auto precomputed = predicate.precompute(builder, area);
+    auto precomputed = predicate.precompute(cache);
     vector<Vec2> pos;
     const int margin = getValueMaybe(minMargin, maker).value_or(0);
     if (contains({LevelBuilder::CW1, LevelBuilder::CW3}, rotation))
@@ -1217,10 +1400,12 @@ class RandomLocations : public LevelMaker {
     vector<LevelBuilder::Rot> rotations;
     {
       PROFILE_BLOCK("precomputing");
+      // Many makers share predicates, so evaluate each one only once over the area.
+      PredicateCache cache(builder, area);
       for (int i : All(insideMakers)) {
         pair<vector<Vec2>, LevelBuilder::Rot> res;
         for (auto iter : Range(100)) {
-          res = getAllowedPositions(builder, area, insideMakers[i].get(), predicate[i], sizes[i]);
+          res = getAllowedPositions(cache, insideMakers[i].get(), predicate[i], sizes[i]);
           if (!res.first.empty())
             break;
         }
@@ -1358,7 +1543,7 @@ class Margin : public LevelMaker {
   PLevelMaker inside;
 };
 
-void raiseLocalMinima(Table<double>& t) {
+void raiseLocalMinima(Table<float>& t) {
   Vec2 minPos = t.getBounds().topLeft();
   for (Vec2 v : t.getBounds())
     if (t[v] < t[minPos])
@@ -1381,15 +1566,6 @@ void raiseLocalMinima(Table<double>& t) {
   }
 }
 
-vector<double> sortedValues(const Table<double>& t) {
-  vector<double> values;
-  for (Vec2 v : t.getBounds()) {
-    values.push_back(t[v]);
-  }
-  std::sort(values.begin(), values.end());
-  return values;
-}
-
 class SetSunlight : public LevelMaker {
   public:
   SetSunlight(double a, Predicate p) : amount(a), pred(p) {}
@@ -1437,18 +1613,26 @@ class Mountains : public LevelMaker {
   }
 
   virtual void make(LevelBuilder* builder, Rectangle area) override {
-    Table<double> wys = genNoiseMap(builder->getRandom(), area, noiseInit, varianceMult);
+    Table<float> wys = genNoiseMap(builder->getRandom(), area, noiseInit, varianceMult);
     raiseLocalMinima(wys);
-    vector<double> values = sortedValues(wys);
-    double cutOffLowland = values[min(values.size() - 1, (int)(info.lowlandRatio * double(values.size() - 1)))];
-    int cutOffHillIndex = min(values.size() - 1, (int)((info.hillRatio + info.lowlandRatio) * double(values.size() - 1)));
-    double cutOffHill = values[cutOffHillIndex];
-    double cutOffDarkness = values[min(values.size() - 1, (int)((info.hillRatio + info.lowlandRatio + 1.0) * 0.5 * double(values.size() - 1)))];
+    int lastIndex = area.width() * area.height() - 1;
+    int cutOffHillIndex = min(lastIndex, (int)((info.hillRatio + info.lowlandRatio) * double(lastIndex)));
     const int numMountainLevels = info.numMountainLevels;
-    vector<double> mountainLevelCutoffs;
+    vector<int> indices {
+      min(lastIndex, (int)(info.lowlandRatio * double(lastIndex))),
+      cutOffHillIndex,
+      min(lastIndex, (int)((info.hillRatio + info.lowlandRatio + 1.0) * 0.5 * double(lastIndex)))
+    };
     for (int i : Range(1, numMountainLevels + 1))
-      mountainLevelCutoffs.push_back(values[cutOffHillIndex * (numMountainLevels - i) / numMountainLevels 
-          + (values.size() - 1) * i / numMountainLevels]);
+      indices.push_back(cutOffHillIndex * (numMountainLevels - i) / numMountainLevels
+          + lastIndex * i / numMountainLevels);
+    auto cutOffs = getSortedValues(wys, indices);
+    double cutOffLowland = cutOffs[0];
+    double cutOffHill = cutOffs[1];
+    double cutOffDarkness = cutOffs[2];
+    vector<double> mountainLevelCutoffs;
+    for (int i : Range(numMountainLevels))
+      mountainLevelCutoffs.push_back(cutOffs[3 + i]);
     int dCnt = 0, mCnt = 0, hCnt = 0, lCnt = 0;
     Table<bool> isMountain(area, false);
     for (Vec2 v : area) {
@@ -1524,22 +1708,28 @@ class Roads : public LevelMaker {
         points.push_back(v);
         INFO << "Connecting point " << v;
       }
+    if (points.empty())
+      return;
+    // Each point is joined to the nearest part of the road network built so far.
+    search.reset(area);
+    search.addToTree(points[0]);
     for (int ind : Range(1, points.size())) {
-      Vec2 p1 = points[ind];
-      Vec2 p2 = points[ind - 1];
-      ShortestPath path(area,
-          [=](Vec2 pos) { return (pos == p1 || pos == p2) ? 1 : getValue(builder, pos); },
-          [p2] (Vec2 to) { return p2.dist4(to); },
-          Vec2::directions4(builder->getRandom()), p1, p2);
-      for (Vec2 v = p2; v != p1; v = path.getNextMove(v)) {
-        if (!path.isReachable(v))
-          failGen();
+      Vec2 target = points[ind];
+      auto path = search.connect(target, [&](Vec2 pos) { return getValue(builder, pos); },
+          Vec2::directions4(builder->getRandom()));
+      if (!path)
+        failGen();
+      for (Vec2 v : *path) {
         auto roadType = getRoadType(builder, v);
-        if (v != p2 && v != p1 && !builder->isFurnitureType(v, roadType))
+        if (v != target && !builder->isFurnitureType(v, roadType))
           builder->putFurniture(v, roadType);
+        search.addToTree(v);
       }
     }
   }
+
+  private:
+  ConnectSearch search;
 };
 
 class StartingPos : public LevelMaker {
@@ -1550,7 +1740,7 @@ class StartingPos : public LevelMaker {
   virtual void make(LevelBuilder* builder, Rectangle area) override {
     for (Vec2 pos : area)
       if (predicate.apply(builder, pos))
-        builder->modSquare(pos)->setLandingLink(stairKey);
+        builder->setLandingLink(pos, stairKey);
   }
 
   private:
@@ -1569,7 +1759,7 @@ class TransferPos : public LevelMaker {
       if (((pos.x - area.left() < width) || (pos.y - area.top() < width) ||
           (area.right() - pos.x <= width) || (area.bottom() - pos.y <= width)) &&
           predicate.apply(builder, pos)) {
-        builder->modSquare(pos)->setLandingLink(stairKey);
+        builder->setLandingLink(pos, stairKey);
         found = true;
       }
     checkGen(found);
@@ -1587,9 +1777,9 @@ class Forrest : public LevelMaker {
 
   virtual void make(LevelBuilder* builder, Rectangle area) override {
     auto furnitureList = builder->getContentFactory()->furniture.getFurnitureList(info.trees);
-    Table<double> wys = genNoiseMap(builder->getRandom(), area, {0, 0, 0, 0, 0}, 0.65);
-    vector<double> values = sortedValues(wys);
-    double cutoff = values[min(values.size() - 1, int(values.size() * info.ratio))];
+    Table<float> wys = genNoiseMap(builder->getRandom(), area, {0, 0, 0, 0, 0}, 0.65);
+    int numValues = area.width() * area.height();
+    double cutoff = getSortedValues(wys, {min(numValues - 1, int(numValues * info.ratio))})[0];
     auto pred = Predicate::type(info.onType);
     for (Vec2 v : area)
       if (pred.apply(builder, v) && builder->canNavigate(v, {MovementTrait::WALK}) && wys[v] < cutoff) {
@@ -2859,6 +3049,13 @@ static PMakerQueue getSettlementMaker(const ContentFactory& contentFactory, Rand
       });
 }
 
+static string getLayoutName(const LayoutType& type) {
+  return type.visit(
+      [&] (const MapLayoutTypes::RandomLayout& info) -> string { return info.id.data(); },
+      [&] (const MapLayoutTypes::Predefined& info) -> string { return info.id.data(); },
+      [&] (const MapLayoutTypes::Builtin& info) -> string { return EnumInfo<BuiltinLayoutId>::getString(info.id); });
+}
+
 constexpr int mapBorderUnavailableWidth = 2;
 
 PLevelMaker LevelMaker::topLevel(RandomGen& random, vector<SettlementInfo> settlements, int mapWidth, int difficulty,
@@ -2900,20 +3097,22 @@ PLevelMaker LevelMaker::topLevel(RandomGen& random, vector<SettlementInfo> settl
   vector<SurroundWithResourcesInfo> surroundWithResources;
   for (SettlementInfo settlement : settlements) {
     auto queue = getSettlementMaker(contentFactory, random, settlement, difficulty);
-    if (settlement.crops)
-      addedCrops.push_back({*settlement.crops, settlement, queue.get()});
     if (settlement.corpses)
       queue->addMaker(make_unique<Corpses>(*settlement.corpses));
+    // Retry a failed settlement in place before giving up on the whole model.
+    auto maker = make_unique<RetryMaker>(std::move(queue), getLayoutName(settlement.type), settlement.collective, 3);
+    if (settlement.crops)
+      addedCrops.push_back({*settlement.crops, settlement, maker.get()});
     if (settlement.surroundWithResources > 0)
-      surroundWithResources.push_back({queue.get(), settlement});
+      surroundWithResources.push_back({maker.get(), settlement});
     if (!!startingPos) {
       if (settlement.closeToPlayer) {
-        locations->setMinDistance(startingPos, queue.get(), 20);
-        locations->setMaxDistance(startingPos, queue.get(), 40);
+        locations->setMinDistance(startingPos, maker.get(), 20);
+        locations->setMaxDistance(startingPos, maker.get(), 40);
       } else
-        locations->setMinDistance(startingPos, queue.get(), 40);
+        locations->setMinDistance(startingPos, maker.get(), 40);
     }
-    locations->add(std::move(queue), getSize(contentFactory.mapLayouts, random, settlement.type),
+    locations->add(std::move(maker), getSize(contentFactory.mapLayouts, random, settlement.type),
         getSettlementPredicate(settlement.type));
   }
   Predicate lowlandPred = Predicate::attrib(SquareAttrib::LOWLAND) && !Predicate::attrib(SquareAttrib::RIVER);
@@ -3321,3 +3520,8 @@ PLevelMaker LevelMaker::upLevel(Position pos, const BiomeInfo& biomeInfo, vector
   all->addMaker(make_unique<AddMapBorder>(mapBorderUnavailableWidth));
   return std::move(all);
 }
+
+map<string, LevelMaker::RetryStats>& LevelMaker::getRetryStats() {
+  static map<string, RetryStats> ret;
+  return ret;
+}
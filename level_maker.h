@@ -43,6 +43,13 @@ class LevelMaker {
   virtual void make(LevelBuilder* builder, Rectangle area) = 0;
   virtual ~LevelMaker() {}
 
+  struct RetryStats {
+    int numTries = 0;
+    int numFailures = 0;
+  };
+  /** Tries and failures of settlement makers, which are retried in place when they fail. Keyed by layout name.*/
+  static map<string, RetryStats>& getRetryStats();
+
   static PLevelMaker topLevel(RandomGen&, vector<SettlementInfo> village, int width, int difficulty,
       optional<TribeId> keeperTribe, optional<KeeperBaseInfo>, BiomeInfo, ResourceCounts, const ContentFactory&);
   static PLevelMaker mineTownLevel(RandomGen&, SettlementInfo, Vec2 size, int difficulty);
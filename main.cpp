@@ -126,6 +126,7 @@ static po::parser getCommandLineFlags() {
   flags["data_dir"].type(po::string).description("Directory containing the game data");
   flags["restore_settings"].description("Restore settings to default values.");
   flags["run_tests"].description("Run all unit tests and exit");
+  flags["bench_level_tick"].description("Measure the time of a level tick on a test fortress and exit");
   flags["worldgen_test"].type(po::i32).description("Test how often world generation fails");
   flags["worldgen_maps"].type(po::string).description("List of maps or enemy types in world generation test. Skip to test all.");
   flags["battle_level"].type(po::string).description("Path to battle test level");
@@ -147,6 +148,7 @@ static po::parser getCommandLineFlags() {
   flags["quick_game"].description("Skip main menu and load the last save file or start a single map game");
   flags["new_game"].description("Skip main menu and start a single map game");
   flags["max_turns"].type(po::i32).description("Quit the game after a given max number of turns");
+  flags["check_caches"].description("Periodically check incrementally updated caches against a full recomputation");
 #endif
   return flags;
 }
@@ -263,6 +265,10 @@ static int keeperMain(po::parser& commandLineFlags) {
     testAll();
     return 0;
   }
+  if (commandLineFlags["bench_level_tick"].was_set()) {
+    benchmarkLevelTick();
+    return 0;
+  }
   DirectoryPath dataPath([&]() -> string {
     if (commandLineFlags["data_dir"].was_set())
       return commandLineFlags["data_dir"].get().string;
@@ -296,6 +302,8 @@ static int keeperMain(po::parser& commandLineFlags) {
   optional<int> maxTurns;
   if (commandLineFlags["max_turns"].was_set())
     maxTurns = commandLineFlags["max_turns"].get().i32;
+  if (commandLineFlags["check_caches"].was_set())
+    CacheCheck::enable();
   Clock clock(!!maxTurns);
   userPath.createIfDoesntExist();
   auto settingsPath = userPath.file("options_v1_0.txt");
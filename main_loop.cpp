@@ -910,11 +910,75 @@ GameConfig MainLoop::getGameConfig(const vector<string>& modNames) const {
       .transform([&](const string& name) { return modsDir.subdirectory(name); })));
 }
 
+static bool loadContentCache(ContentFactory& factory, const FilePath& path, size_t key) {
+  if (!path.exists())
+    return false;
+  try {
+    CompressedInput input(path.getPath());
+    size_t cacheKey;
+    input.getArchive() >> cacheKey;
+    if (cacheKey != key)
+      return false;
+    // Ids must get the same internal numbers as a text parse would give them, otherwise everything
+    // ordered or hashed by content id would behave differently depending on whether the cache was used.
+    ContentIdTables idTables;
+    input.getArchive() >> idTables;
+    if (!restoreContentIdTables(idTables)) {
+      INFO << "Content cache id order doesn't match";
+      return false;
+    }
+    ContentFactory tmp;
+    input.getArchive() >> tmp;
+    factory = std::move(tmp);
+    return true;
+  } catch (std::exception&) {
+    return false;
+  }
+}
+
+static const string contentCachePrefix = "content_cache_";
+
+static FilePath getContentCachePath(const DirectoryPath& userPath, const vector<string>& modNames) {
+  return userPath.file(contentCachePrefix + toString(combineHash(modNames)) + ".dat");
+}
+
+static void saveContentCache(const ContentFactory& factory, const DirectoryPath& userPath,
+    const vector<string>& modNames, size_t key) {
+  auto path = getContentCachePath(userPath, modNames);
+  FilePath tmpPath = path.withSuffix(".tmp");
+  {
+    CompressedOutput out(tmpPath.getPath());
+    out.getArchive() << key << getContentIdTables() << factory;
+  }
+  tmpPath.copyTo(path);
+  tmpPath.erase();
+  // Only keep the caches of the current mod list and of vanilla, which is the fallback.
+  auto vanillaPath = getContentCachePath(userPath, {});
+  for (auto& file : userPath.getFiles())
+    if (!strncmp(file.getFileName(), contentCachePrefix.data(), contentCachePrefix.size()) &&
+        !(file == path) && !(file == vanillaPath))
+      file.erase();
+}
+
+optional<string> MainLoop::readContentFactory(ContentFactory& factory, const GameConfig& config,
+    const vector<string>& modNames) const {
+  auto key = combineHash(config.getContentHash(), modNames, string(BUILD_DATE) + " " + BUILD_VERSION);
+  bool loaded = false;
+  MEASURE(loaded = loadContentCache(factory, getContentCachePath(userPath, modNames), key), "Loading content cache");
+  if (loaded)
+    return none;
+  optional<string> error;
+  MEASURE(error = factory.readData(&config, modNames), "Parsing game config");
+  if (!error)
+    saveContentCache(factory, userPath, modNames, key);
+  return error;
+}
+
 ContentFactory MainLoop::createContentFactory(bool vanillaOnly) const {
   ContentFactory ret;
   auto tryConfig = [&](const vector<string>& modNames) {
     auto config = getGameConfig(modNames);
-    return ret.readData(&config, modNames);
+    return readContentFactory(ret, config, modNames);
   };
   if (vanillaOnly) {
 #ifdef RELEASE
@@ -1273,6 +1337,17 @@ ModelTable MainLoop::prepareCampaignModels(CampaignSetup& setup, const AvatarInf
   int numSites = setup.campaign.getNumNonEmpty();
   vector<ContentFactory> factories;
   int numRetiredVillains = 0;
+  auto& random = modelBuilder.getRandom();
+  // Every generated site uses its own substream identified by the campaign seed and the site's position, so
+  // its contents don't depend on which sites were generated before it. The shared generator is swapped back
+  // afterwards.
+  auto campaignSeed = random.getLL();
+  auto withSiteRandom = [&] (Vec2 v, auto fun) {
+    auto siteRandom = random.substream(campaignSeed, v.x, v.y);
+    std::swap(random, siteRandom);
+    OnExit restore([&] { std::swap(random, siteRandom); });
+    return fun();
+  };
   doWithSplash("Generating map...", numSites,
       [&] (ProgressMeter& meter) {
         for (Vec2 v : sites.getBounds()) {
@@ -1280,7 +1355,7 @@ ModelTable MainLoop::prepareCampaignModels(CampaignSetup& setup, const AvatarInf
             meter.addProgress();
           int difficulty = setup.campaign.getBaseLevelIncrease(v);
           if (auto info = sites[v].getKeeper()) {
-            models[v] = getBaseModel(modelBuilder, setup, avatarInfo);
+            models[v] = withSiteRandom(v, [&] { return getBaseModel(modelBuilder, setup, avatarInfo); });
           } else if (auto villain = sites[v].getVillain()) {
             for (auto& info : getSaveFiles(userPath, getSaveSuffix(GameSaveType::RETIRED_SITE))) {
               auto version = getSaveVersion(info);
@@ -1295,9 +1370,12 @@ ModelTable MainLoop::prepareCampaignModels(CampaignSetup& setup, const AvatarInf
                         break;
                       }
             }
-            if (!models[v])
-              models[v] = modelBuilder.campaignSiteModel(villain->enemyId, villain->type, avatarInfo.tribeAlignment,
-                  *setup.campaign.getSites()[v].biome, difficulty);
+            if (!models[v]) {
+              models[v] = withSiteRandom(v, [&] {
+                return modelBuilder.campaignSiteModel(villain->enemyId, villain->type, avatarInfo.tribeAlignment,
+                    *setup.campaign.getSites()[v].biome, difficulty);
+              });
+            }
             for (auto c : models[v]->getAllCreatures())
               c->setCombatExperience(difficulty);
           } else if (auto retired = sites[v].getRetired()) {
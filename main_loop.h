@@ -124,6 +124,7 @@ class MainLoop {
   vector<ModInfo> getOnlineMods();
   GameConfig getVanillaConfig() const;
   GameConfig getGameConfig(const vector<string>& modNames) const;
+  optional<string> readContentFactory(ContentFactory&, const GameConfig&, const vector<string>& modNames) const;
   DirectoryPath getVanillaDir() const;
   template<typename T>
   optional<T> loadFromFile(const FilePath&);
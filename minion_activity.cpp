@@ -21,10 +21,42 @@
 #include "item.h"
 #include "dancing.h"
 #include "level.h"
+#include "movement_type.h"
+#include "sectors.h"
 
 SERIALIZE_DEF(MinionActivities, allFurniture, activities)
 SERIALIZATION_CONSTRUCTOR_IMPL(MinionActivities)
 
+namespace {
+struct ReachableKey {
+  FurnitureType HASH(type);
+  Level* HASH(level);
+  int HASH(sector);
+  MovementType HASH(movement);
+  bool operator == (const ReachableKey& o) const {
+    return type == o.type && level == o.level && sector == o.sector && movement == o.movement;
+  }
+  HASH_ALL(type, level, sector, movement)
+};
+}
+
+/** Built furniture positions per activity, shared by all minions of the collective. They are dropped when the
+    built furniture changes, or every turn if the activity has a secondary predicate, which looks at more than
+    the furniture type. Reachability depends only on the level and sector that the minion is in, so it's
+    cached per sector for the current turn.*/
+struct MinionActivities::PositionCache {
+  struct ActivityCache {
+    int builtVersion = -1;
+    optional<LocalTime> builtTime;
+    HashMap<FurnitureType, PositionList> built;
+    optional<LocalTime> reachableTime;
+    HashMap<ReachableKey, PositionList> reachable;
+  };
+  EnumMap<MinionActivity, ActivityCache> activities;
+};
+
+MinionActivities::~MinionActivities() {}
+
 static bool betterPos(Position from, Position current, Position candidate) {
   PROFILE;
   return from.dist8(current).value_or(1000000) > from.dist8(candidate).value_or(1000000);
@@ -143,33 +175,73 @@ static vector<Position> tryInQuarters(vector<Position> pos, const Collective* co
   return tryInQuarters(std::move(pos), collective, c, [](const Position& pos) -> const Position& { return pos; });
 }
 
+const MinionActivities::PositionList& MinionActivities::getBuiltPositions(const Collective* collective,
+    MinionActivity activity, FurnitureType type) const {
+  auto& info = CollectiveConfig::getActivityInfo(activity);
+  auto& cache = positionCache->activities[activity];
+  auto version = collective->getConstructions().getBuiltVersion();
+  auto time = collective->getLocalTime();
+  if (cache.builtVersion != version || (info.secondaryPredicate && cache.builtTime != time)) {
+    cache.builtVersion = version;
+    cache.builtTime = time;
+    cache.built.clear();
+    cache.reachable.clear();
+  }
+  if (auto ret = getReferenceMaybe(cache.built, type))
+    return *ret;
+  PROFILE_BLOCK("cache built positions");
+  auto layer = collective->getGame()->getContentFactory()->furniture.getData(type).getLayer();
+  auto& ret = cache.built[type];
+  for (auto& pos : collective->getConstructions().getBuiltPositions(type))
+    if (!info.secondaryPredicate || info.secondaryPredicate(pos.getFurniture(layer), collective))
+      ret.push_back(make_pair(pos, layer));
+  return ret;
+}
+
+const MinionActivities::PositionList& MinionActivities::getReachablePositions(const Collective* collective,
+    const Creature* c, MinionActivity activity, FurnitureType type) const {
+  auto& built = getBuiltPositions(collective, activity, type);
+  auto& cache = positionCache->activities[activity];
+  auto time = collective->getLocalTime();
+  if (cache.reachableTime != time) {
+    cache.reachableTime = time;
+    cache.reachable.clear();
+  }
+  auto movement = c->getMovementType();
+  auto from = c->getPosition();
+  auto filter = [&] (PositionList& ret) {
+    PROFILE_BLOCK("can navigate to");
+    for (auto& elem : built)
+      if (elem.first.canNavigateToOrNeighbor(from, movement))
+        ret.push_back(elem);
+  };
+  auto sector = from.isValid() ? from.getLevel()->getSectors(movement).getSector(from.getCoord()) : none;
+  if (!sector) {
+    static PositionList ret;
+    ret.clear();
+    filter(ret);
+    return ret;
+  }
+  auto key = ReachableKey{type, from.getLevel(), *sector, movement};
+  if (auto ret = getReferenceMaybe(cache.reachable, key))
+    return *ret;
+  auto& ret = cache.reachable[key];
+  filter(ret);
+  return ret;
+}
+
 vector<pair<Position, FurnitureLayer>> MinionActivities::getAllPositions(const Collective* collective,
     const Creature* c, MinionActivity activity) const {
   auto profileName = "MinionActivities::getAllPositions " + EnumInfo<MinionActivity>::getString(activity);
   PROFILE_BLOCK(profileName.data());
   vector<pair<Position, FurnitureLayer>> ret;
   auto& info = CollectiveConfig::getActivityInfo(activity);
-  {
-    PROFILE_BLOCK("get all positions");
-    for (auto furnitureType : getAllFurniture(activity))
-      if (info.furniturePredicate(collective->getGame()->getContentFactory(), collective, c, furnitureType)) {
-        auto toPair = [layer = collective->getGame()->getContentFactory()->furniture.getData(furnitureType).getLayer()]
-            (Position p) { return make_pair(p, layer); };
-        append(ret, collective->getConstructions().getBuiltPositions(furnitureType).transform(toPair));
-      }
-  }
-  if (info.secondaryPredicate) {
-    PROFILE_BLOCK("secondary predicate");
-    ret = ret.filter([&](const auto& elem) {
-      return info.secondaryPredicate(elem.first.getFurniture(elem.second), collective);
-    });
-  }
-  if (c) {
-    PROFILE_BLOCK("can navigate to");
-    auto movement = c->getMovementType();
-    ret = ret.filter([&](auto& pos) { return pos.first.canNavigateToOrNeighbor(c->getPosition(), movement); });
+  for (auto furnitureType : getAllFurniture(activity))
+    if (info.furniturePredicate(collective->getGame()->getContentFactory(), collective, c, furnitureType))
+      append(ret, c ? getReachablePositions(collective, c, activity, furnitureType)
+          : getBuiltPositions(collective, activity, furnitureType));
+  if (c)
     ret = tryInQuarters(ret, collective, c, [](const pair<Position, FurnitureLayer>& p) -> const Position& { return p.first; });
-  }
   return ret;
 }
 
@@ -42,6 +42,7 @@ class ContentFactory;
 class MinionActivities {
   public:
   MinionActivities(const ContentFactory*);
+  ~MinionActivities();
   static Task* getExisting(Collective*, Creature*, MinionActivity);
   PTask generate(Collective*, Creature*, MinionActivity) const;
   static PTask generateDropTask(Collective*, Creature*, MinionActivity);
@@ -55,4 +56,9 @@ class MinionActivities {
   private:
   EnumMap<MinionActivity, vector<FurnitureType>> SERIAL(allFurniture);
   HashMap<FurnitureType, MinionActivity> SERIAL(activities);
+  struct PositionCache;
+  mutable HeapAllocated<PositionCache> positionCache;
+  using PositionList = vector<pair<Position, FurnitureLayer>>;
+  const PositionList& getBuiltPositions(const Collective*, MinionActivity, FurnitureType) const;
+  const PositionList& getReachablePositions(const Collective*, const Creature*, MinionActivity, FurnitureType) const;
 };
@@ -99,6 +99,68 @@ vector<Collective*> Model::getCollectives() const {
   return getWeakPointers(collectives);
 }
 
+static Collective* getTerritoryOwner(const vector<PCollective>& collectives, Position pos, int* numClaims = nullptr) {
+  Collective* ret = nullptr;
+  int count = 0;
+  for (auto& col : collectives)
+    if (col->getTerritory().contains(pos)) {
+      ++count;
+      if (!ret || ret->getVillainType() != VillainType::PLAYER)
+        ret = col.get();
+    }
+  if (numClaims)
+    *numClaims = count;
+  return ret;
+}
+
+const PositionSet& Model::getSharedTerritory() const {
+  if (!sharedTerritory) {
+    sharedTerritory.emplace();
+    for (auto& col : collectives)
+      for (auto& pos : col->getTerritory().getAll()) {
+        int numClaims = 0;
+        getTerritoryOwner(collectives, pos, &numClaims);
+        if (numClaims > 1)
+          sharedTerritory->insert(pos);
+      }
+  }
+  return *sharedTerritory;
+}
+
+void Model::onItemsChanged(Position pos) {
+  if (getSharedTerritory().count(pos)) {
+    for (auto& col : collectives)
+      col->onItemsChanged(pos);
+  } else if (auto owner = pos.getCollective())
+    owner->onItemsChanged(pos);
+}
+
+void Model::updateTerritoryOwner(Position pos) {
+  int numClaims = 0;
+  pos.getLevel()->territory[pos.getCoord()] = getTerritoryOwner(collectives, pos, &numClaims);
+  if (sharedTerritory) {
+    if (numClaims > 1)
+      sharedTerritory->insert(pos);
+    else
+      sharedTerritory->erase(pos);
+  }
+}
+
+void Model::checkTerritoryOwners() const {
+  for (auto& l : levels)
+    for (auto v : l->territory.getBounds())
+      if (auto owner = l->territory[v])
+        CHECK(owner == getTerritoryOwner(collectives, Position(v, l.get())))
+            << "Territory owner out of date at " << v;
+  for (auto& col : collectives)
+    for (auto& pos : col->getTerritory().getAll()) {
+      int numClaims = 0;
+      CHECK(pos.getLevel()->territory[pos.getCoord()] == getTerritoryOwner(collectives, pos, &numClaims))
+          << "Territory owner out of date at " << pos.getCoord();
+      CHECK((numClaims > 1) == getSharedTerritory().count(pos)) << "Shared territory out of date at " << pos.getCoord();
+    }
+}
+
 void Model::updateSunlightMovement() {
   for (PLevel& l : levels)
     l->updateSunlightMovement();
@@ -152,15 +214,8 @@ void Model::tick(LocalTime time) { PROFILE
     l->tick();
   for (PCollective& col : collectives)
     col->tick();
-  for (auto& l : levels)
-    for (auto v : l->territory.getBounds())
-      l->territory[v] = nullptr;
-  for (auto& col : collectives)
-    for (auto& pos : col->getTerritory().getAll()) {
-      auto& value = pos.getLevel()->territory[pos.getCoord()];
-      if (!value || value->getVillainType() != VillainType::PLAYER)
-        value = col.get();
-    }
+  if (territoryCheck.isDue())
+    checkTerritoryOwners();
   if (externalEnemies)
     externalEnemies->update(getGroundLevel(), time);
   stairNavigation.clear();
@@ -347,6 +402,8 @@ Level* Model::getMainLevel(int depth) const {
 
 void Model::addCollective(PCollective col) {
   collectives.push_back(std::move(col));
+  for (auto& pos : collectives.back()->getTerritory().getAll())
+    updateTerritoryOwner(pos);
   if (game)
     game->addCollective(collectives.back().get());
 }
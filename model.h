@@ -72,6 +72,9 @@ class Model : public OwnedObject<Model> {
   Game* getGame() const;
   void tick(LocalTime);
   vector<Collective*> getCollectives() const;
+  void onItemsChanged(Position);
+  /** Recomputes which collective owns the square. Must be called whenever a collective's territory changes.*/
+  void updateTerritoryOwner(Position);
   vector<Creature*> getAllCreatures() const;
   const vector<PCreature>& getDeadCreatures() const;
   vector<Level*> getLevels() const;
@@ -144,6 +147,11 @@ class Model : public OwnedObject<Model> {
   friend class EventListener;
   OwnerPointer<EventGenerator> SERIAL(eventGenerator);
   void checkCreatureConsistency();
+  void checkTerritoryOwners() const;
+  // Squares claimed by more than one collective, which all need item updates. Not serialized, built on first use.
+  mutable optional<PositionSet> sharedTerritory;
+  const PositionSet& getSharedTerritory() const;
+  CacheCheck territoryCheck;
   heap_optional<ExternalEnemies> SERIAL(externalEnemies);
   int moveCounter = 0;
   optional<MusicType> SERIAL(defaultMusic);
@@ -11,6 +11,7 @@
 #include "square.h"
 #include "progress_meter.h"
 #include "level_maker.h"
+#include "perlin_noise.h"
 #include "model.h"
 #include "level_builder.h"
 #include "monster_ai.h"
@@ -52,6 +53,10 @@ ModelBuilder::ModelBuilder(ProgressMeter* m, RandomGen& r, Options* o,
 ModelBuilder::~ModelBuilder() {
 }
 
+RandomGen& ModelBuilder::getRandom() {
+  return random;
+}
+
 ModelBuilder::LevelMakerMethod ModelBuilder::getMaker(LevelType type) {
   switch (type) {
     case LevelType::BASIC:
@@ -214,6 +219,8 @@ void ModelBuilder::measureModelGen(const string& name, int numTries, function<vo
   int minT = 1000000;
   double sumT = 0;
   USER_INFO << "Testing " << name;
+  LevelMaker::getRetryStats().clear();
+  getNoiseMapStats() = NoiseMapStats{};
   for (int i : Range(numTries)) {
 #ifndef OSX // this triggers some compiler errors OSX, I don't need it there anyway.
     auto time = steady_clock::now();
@@ -236,6 +243,11 @@ void ModelBuilder::measureModelGen(const string& name, int numTries, function<vo
   }
   USER_INFO << numSuccess << " / " << numTries << ". MinT: " <<
     minT << ". MaxT: " << maxT << ". AvgT: " << sumT / numTries;
+  auto& noiseStats = getNoiseMapStats();
+  USER_INFO << "  Noise maps: " << noiseStats.numMaps << ", AvgT: " << noiseStats.millis / numTries;
+  for (auto& elem : LevelMaker::getRetryStats())
+    if (elem.second.numFailures > 0)
+      USER_INFO << "  " << elem.first << " failed " << elem.second.numFailures << " / " << elem.second.numTries;
 }
 
 void ModelBuilder::makeExtraLevel(Model* model, LevelConnection& connection, SettlementInfo& mainSettlement,
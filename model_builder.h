@@ -38,6 +38,8 @@ class ModelBuilder {
 
   PModel battleModel(const FilePath& levelPath, vector<PCreature> allies, vector<CreatureList> enemies);
 
+  RandomGen& getRandom();
+
   ~ModelBuilder();
 
   private:
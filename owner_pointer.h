@@ -93,16 +93,18 @@ class OwnerPointer {
   shared_ptr<T> SERIAL(elem);
 };
 
+// Keeps a plain pointer next to the weak_ptr, so that dereferencing only needs to check if the
+// object has expired instead of locking, which would do two atomic reference count updates.
 template <typename T>
 class WeakPointer {
   public:
 
   template <typename U>
-  WeakPointer(const WeakPointer<U>& o) : elem(o.elem) {
+  WeakPointer(const WeakPointer<U>& o) : elem(o.elem), ptr(o.ptr) {
   }
 
   template <typename U>
-  WeakPointer(WeakPointer<U>&& o) : elem(std::move(o.elem)) {
+  WeakPointer(WeakPointer<U>&& o) : elem(std::move(o.elem)), ptr(o.ptr) {
   }
 
   WeakPointer(T* t) : WeakPointer(t->getThis().template dynamicCast<T>()) {}
@@ -113,17 +115,19 @@ class WeakPointer {
   template <typename U>
   WeakPointer<T>& operator = (WeakPointer<U>&& o) {
     elem = std::move(o.elem);
+    ptr = o.ptr;
     return *this;
   }
 
   template <typename U>
   WeakPointer<T>& operator = (const WeakPointer<U>& o) {
     elem = o.elem;
+    ptr = o.ptr;
     return *this;
   }
 
   WeakPointer<T>& operator = (std::nullptr_t) {
-    elem.reset();
+    clear();
     return *this;
   }
 
@@ -144,22 +148,23 @@ class WeakPointer {
 
   void clear() {
     elem.reset();
+    ptr = nullptr;
   }
 
   T* operator -> () const {
-    return elem.lock().get();
+    return get();
   }
 
   T& operator * () const {
-    return *elem.lock().get();
+    return *get();
   }
 
   explicit operator bool() const {
-    return !!elem.lock();
+    return !!get();
   }
 
   bool operator !() const {
-    return !elem.lock();
+    return !get();
   }
 
   template <typename U>
@@ -181,23 +186,26 @@ class WeakPointer {
   }
 
   bool operator == (std::nullptr_t) const {
-    return !elem.lock();
+    return !get();
   }
 
   bool operator != (std::nullptr_t) const {
-    return !!elem.lock();
+    return !!get();
   }
 
   T* get() const {
-    return elem.lock().get();
+    return elem.expired() ? nullptr : ptr;
   }
 
   int getHash() const {
-    auto sp = elem.lock();
-    return std::hash<decltype(sp)>()(sp);
+    return std::hash<T*>()(get());
   }
 
-  SERIALIZE_ALL(elem)
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int) {
+    ar(elem);
+    ptr = elem.lock().get();
+  }
 
   private:
   template<class U>
@@ -207,9 +215,10 @@ class WeakPointer {
   friend class OwnerPointer;
   template <typename>
   friend class WeakPointer;
-  WeakPointer(const shared_ptr<T>& e) : elem(e) {}
+  WeakPointer(const shared_ptr<T>& e) : elem(e), ptr(e.get()) {}
 
   weak_ptr<T> SERIAL(elem);
+  T* ptr = nullptr;
 };
 
 template<typename T>
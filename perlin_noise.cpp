@@ -1,66 +1,112 @@
 #include "util.h"
 #include "perlin_noise.h"
 
-void addAvg(int x, int y, const Table<double>& wys, double& avg, int& num) {
-  Vec2 pos(x, y);
-  if (pos.inRectangle(wys.getBounds())) {
-    avg += wys[pos];
-    ++num;
+// Counter based random offset in [-1, 1). Each cell's offset depends only on the seed, the step size and the
+// cell's coordinates, so rows can be filled in any order.
+static float getOffset(uint64_t seed, int step, int x, int y) {
+  uint64_t v = seed ^ (uint64_t(step) << 48) ^ (uint64_t(uint32_t(y)) << 24) ^ uint64_t(uint32_t(x));
+  v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  v = (v ^ (v >> 27)) * 0x94d049bb133111ebULL;
+  v ^= v >> 31;
+  return float(v >> 40) * (2.0f / float(1 << 24)) - 1.0f;
+}
+
+namespace {
+class NoiseGrid {
+  public:
+  NoiseGrid(int width) : width(width), values(width * width) {}
+
+  float& operator()(int x, int y) {
+    return values[x + y * width];
+  }
+
+  // Average of the given neighbors, skipping the ones outside of the grid.
+  float getAverage(std::initializer_list<pair<int, int>> neighbors) {
+    float sum = 0;
+    int num = 0;
+    for (auto& v : neighbors)
+      if (v.first >= 0 && v.second >= 0 && v.first < width && v.second < width) {
+        sum += (*this)(v.first, v.second);
+        ++num;
+      }
+    return sum / num;
   }
+
+  const int width;
+
+  private:
+  std::vector<float> values;
+};
 }
 
-Table<double> genNoiseMap(RandomGen& random, Rectangle area, NoiseInit init, double varianceMult) {
+static Table<float> genNoiseMapImpl(RandomGen& random, Rectangle area, NoiseInit init, double varianceMult) {
   int width = 1;
   while (width < area.width() - 1 || width < area.height() - 1)
     width *= 2;
   width /= 2;
   ++width;
-  Table<double> wys(width, width);
-  wys[0][0] = init.topLeft;
-  wys[width - 1][0] = init.topRight;
-  wys[width - 1][width - 1] = init.bottomRight;
-  wys[0][width - 1] = init.bottomLeft;
-  wys[(width - 1) / 2][(width - 1) / 2] = init.middle;
-
-  double variance = 0.5;
-  double heightDiff = 0.1;
+  NoiseGrid wys(width);
+  wys(0, 0) = init.topLeft;
+  wys(width - 1, 0) = init.topRight;
+  wys(width - 1, width - 1) = init.bottomRight;
+  wys(0, width - 1) = init.bottomLeft;
+  wys((width - 1) / 2, (width - 1) / 2) = init.middle;
+  uint64_t seed = random.getLL();
+  float variance = 0.5;
   for (int a = width - 1; a >= 2; a /= 2) {
+    int numCells = (width - 1) / a;
+    int h = a / 2;
     if (a < width - 1)
-      for (Vec2 pos1 : Rectangle((width - 1) / a, (width - 1) / a)) {
-        Vec2 pos = pos1 * a;
-        double avg = (wys[pos] + wys[pos.x + a][pos.y] + wys[pos.x][pos.y + a] + wys[pos.x + a][pos.y + a]) / 4;
-        wys[pos.x + a / 2][pos.y + a / 2] =
-            avg + variance * (random.getDouble() * 2 - 1);
-      }
-    for (Vec2 pos1 : Rectangle((width - 1) / a, (width - 1) / a + 1)) {
-      Vec2 pos = pos1 * a;
-      double avg = 0;
-      int num = 0;
-      addAvg(pos.x + a / 2, pos.y - a / 2, wys, avg, num);
-      addAvg(pos.x, pos.y, wys, avg, num);
-      addAvg(pos.x + a, pos.y, wys, avg, num);
-      addAvg(pos.x + a / 2, pos.y + a / 2, wys, avg, num);
-      wys[pos.x + a / 2][pos.y] =
-          avg / num + variance * (random.getDouble() * 2 - 1);
-    }
-    for (Vec2 pos1 : Rectangle((width - 1) / a + 1, (width - 1) / a)) {
-      Vec2 pos = pos1 * a;
-      double avg = 0;
-      int num = 0;
-      addAvg(pos.x - a / 2, pos.y + a / 2, wys, avg, num);
-      addAvg(pos.x, pos.y, wys, avg, num);
-      addAvg(pos.x, pos.y + a , wys, avg, num);
-      addAvg(pos.x + a / 2, pos.y + a / 2, wys, avg, num);
-      wys[pos.x][pos.y + a / 2] =
-          avg / num + variance * (random.getDouble() * 2 - 1);
-    }
+      for (int y = 0; y < width - 1; y += a)
+        for (int x = 0; x < width - 1; x += a)
+          wys(x + h, y + h) = (wys(x, y) + wys(x + a, y) + wys(x, y + a) + wys(x + a, y + a)) / 4
+              + variance * getOffset(seed, a, x + h, y + h);
+    for (int y = 0; y <= numCells * a; y += a)
+      for (int x = 0; x < width - 1; x += a)
+        wys(x + h, y) = wys.getAverage({{x + h, y - h}, {x, y}, {x + a, y}, {x + h, y + h}})
+            + variance * getOffset(seed, a, x + h, y);
+    for (int y = 0; y < width - 1; y += a)
+      for (int x = 0; x <= numCells * a; x += a)
+        wys(x, y + h) = wys.getAverage({{x - h, y + h}, {x, y}, {x, y + a}, {x + h, y + h}})
+            + variance * getOffset(seed, a, x, y + h);
     variance *= varianceMult;
   }
-  Table<double> ret(area);
+  Table<float> ret(area);
   Vec2 offset(area.left(), area.top());
-  for (Vec2 v : area) {
-    Vec2 lv((v.x - offset.x) * width / area.width(), (v.y - offset.y) * width / area.height());
-    ret[v] = wys[lv];
+  for (Vec2 v : area)
+    ret[v] = wys((v.x - offset.x) * width / area.width(), (v.y - offset.y) * width / area.height());
+  return ret;
+}
+
+Table<float> genNoiseMap(RandomGen& random, Rectangle area, NoiseInit init, double varianceMult) {
+  auto begin = std::chrono::steady_clock::now();
+  auto ret = genNoiseMapImpl(random, area, init, varianceMult);
+  auto& stats = getNoiseMapStats();
+  ++stats.numMaps;
+  stats.millis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  return ret;
+}
+
+vector<float> getSortedValues(const Table<float>& table, const vector<int>& indices) {
+  std::vector<float> values;
+  values.reserve(table.getWidth() * table.getHeight());
+  for (Vec2 v : table.getBounds())
+    values.push_back(table[v]);
+  auto sortedIndices = indices;
+  std::sort(sortedIndices.begin(), sortedIndices.end());
+  // After nth_element all values past the index are not smaller, so the next selection can skip the prefix.
+  int begin = 0;
+  for (int index : sortedIndices) {
+    CHECK(index >= 0 && index < values.size());
+    if (index >= begin) {
+      std::nth_element(values.begin() + begin, values.begin() + index, values.end());
+      begin = index + 1;
+    }
   }
+  return indices.transform([&](int index) { return values[index]; });
+}
+
+NoiseMapStats& getNoiseMapStats() {
+  static NoiseMapStats ret;
   return ret;
 }
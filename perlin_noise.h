@@ -11,4 +11,16 @@ struct NoiseInit {
   int middle;
 };
 
-Table<double> genNoiseMap(RandomGen& random, Rectangle area, NoiseInit, double varianceMult);
+Table<float> genNoiseMap(RandomGen& random, Rectangle area, NoiseInit, double varianceMult);
+
+/** Returns the values that would be at the given indices if all values of the table were sorted.
+    Uses selection instead of sorting, so the cost is linear in the table size for each index.*/
+vector<float> getSortedValues(const Table<float>&, const vector<int>& indices);
+
+struct NoiseMapStats {
+  int numMaps = 0;
+  double millis = 0;
+};
+
+/** Number of noise maps generated and time spent on it, for the world generation test.*/
+NoiseMapStats& getNoiseMapStats();
@@ -102,6 +102,8 @@
 #include "furnace.h"
 #include "promotion_info.h"
 
+static const ContentIdConstant<BuffId> bridgeBuildingSkill("BRIDGE_BUILDING_SKILL");
+
 template <class Archive>
 void PlayerControl::serialize(Archive& ar, const unsigned int version) {
   ar& SUBCLASS(CollectiveControl) & SUBCLASS(EventListener);
@@ -3770,8 +3772,8 @@ void PlayerControl::tick() {
   collective->getConstructions().checkDebtConsistency();
   PROFILE_BLOCK("PlayerControl::tick");
   for (auto c : collective->getCreatures()) {
-    if (c->isAffectedPermanently(BuffId("BRIDGE_BUILDING_SKILL")))
-      c->removePermanentEffect(BuffId("BRIDGE_BUILDING_SKILL"), 1, false);
+    if (c->isAffectedPermanently(bridgeBuildingSkill))
+      c->removePermanentEffect(bridgeBuildingSkill, 1, false);
   }
   considerSoloAchievement();
   updateUnknownLocations();
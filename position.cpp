@@ -35,6 +35,9 @@
 #include "attack_level.h"
 #include "zlevel.h"
 
+static const ContentIdConstant<FurnitureType> bridgeType("BRIDGE");
+static const ContentIdConstant<ViewId> emptyViewId("empty");
+
 template <class Archive>
 void Position::serialize(Archive& ar, const unsigned int) {
   ar(coord, level, valid);
@@ -441,9 +444,15 @@ string Position::getName() const {
 }
 
 void Position::getViewIndex(ViewIndex& index, const Creature* viewer) const {
-  PROFILE;
+  PROFILE_HOT;
   if (isValid()) {
-    getSquare()->getViewIndex(getGame()->getContentFactory(), index, viewer);
+    auto factory = getGame()->getContentFactory();
+    getSquare()->getViewIndex(factory, index, viewer);
+    for (auto& type : factory->tileGasTypes) {
+      auto amount = level->tileGas->getAmount(coord, type.first);
+      if (amount > 0)
+        index.addGasAmount(type.second.name, type.second.color.transparency(amount * 255));
+    }
     if (isUnavailable())
       index.setHighlight(HighlightType::UNAVAILABLE);
     if (isCovered())
@@ -461,7 +470,7 @@ void Position::getViewIndex(ViewIndex& index, const Creature* viewer) const {
       }
     }
     if (index.noObjects())
-      index.insert(ViewObject(ViewId("empty"), ViewLayer::FLOOR_BACKGROUND));
+      index.insert(ViewObject(emptyViewId, ViewLayer::FLOOR_BACKGROUND));
     if (viewer) {
       if (auto& effects = level->furnitureEffects[viewer->getTribeId().getKey()])
         if (!effects->operator[](coord).friendly.empty())
@@ -553,7 +562,7 @@ bool Position::canEnterEmptyCalc(const MovementType& t, optional<FurnitureLayer>
     return false;
   const auto square = getSquare();
   bool result = true;
-  const bool covered = isCovered() || getSquare()->hasSunlightBlockingGasAmount();
+  const bool covered = isCovered() || level->tileGas->hasSunlightBlockingAmount(coord);
   for (auto layer : ENUM_ALL(FurnitureLayer))
     if (layer != ignore)
       if (auto furniture = level->furniture->getBuilt(layer).getReadonly(coord)) {
@@ -763,6 +772,7 @@ void Position::removeFurniture(const Furniture* f, PFurniture replace, Creature*
   } else {
     level->furniture->getBuilt(layer).clearElem(coord);
     level->furniture->eraseConstruction(coord, layer);
+    level->addRoofCandidate(coord, layer);
   }
   updateMovementDueToFire();
   updateConnectivity();
@@ -834,25 +844,32 @@ bool Position::isBurning() const {
   return false;
 }
 
+void Position::updateOnFire() const {
+  if (isValid()) {
+    if (isBurning()) {
+      if (!getSquare()->isOnFire()) {
+        modSquare()->setOnFire(true);
+        updateConnectivity();
+      }
+    } else
+      if (getSquare()->isOnFire()) {
+        modSquare()->setOnFire(false);
+        updateConnectivity();
+      }
+  }
+}
+
 void Position::updateMovementDueToFire() const {
   PROFILE;
-  auto update = [] (const Position& pos) {
-    if (pos.isValid()) {
-      if (pos.isBurning()) {
-        if (!pos.getSquare()->isOnFire()) {
-          pos.modSquare()->setOnFire(true);
-          pos.updateConnectivity();
-        }
-      } else
-        if (pos.getSquare()->isOnFire()) {
-          pos.modSquare()->setOnFire(false);
-          pos.updateConnectivity();
-        }
-    }
-  };
-  update(*this);
+  if (!isValid())
+    return;
+  if (auto& updates = level->fireMovementUpdates) {
+    updates->push_back(coord);
+    return;
+  }
+  updateOnFire();
   for (auto& v : neighbors8())
-    update(v);
+    v.updateOnFire();
 }
 
 bool Position::fireDamage(int amount) const {
@@ -931,12 +948,12 @@ void Position::setNeedsRenderAndMemoryUpdate(bool s) const {
 }
 
 ViewId Position::getTopViewId() const {
-  PROFILE;
+  PROFILE_HOT;
   for (auto layer : ENUM_ALL_REVERSE(FurnitureLayer))
     if (auto furniture = getFurniture(layer))
       if (auto& obj = furniture->getViewObject())
         return obj->id();
-  return ViewId("empty");
+  return emptyViewId;
 }
 
 void Position::forbidMovementForTribe(TribeId t) {
@@ -975,13 +992,13 @@ vector<Position> Position::getVisibleTiles(const Vision& vision) {
 void Position::addGas(TileGasType type, double amount) {
   PROFILE;
   if (isValid())
-    modSquare()->addGas(*this, type, amount);
+    level->tileGas->addAmount(*this, type, amount);
 }
 
 double Position::getGasAmount(TileGasType type) const {
   PROFILE;
   if (isValid())
-    return getSquare()->getGasAmount(type);
+    return level->tileGas->getAmount(coord, type);
   else
     return 0;
 }
@@ -1001,7 +1018,7 @@ bool Position::isCovered() const {
 bool Position::sunlightBurns() const {
   PROFILE;
   return isValid() && !isCovered() && level->lightCapAmount[coord] >= 1 &&
-      getGame()->getSunlightInfo().getState() == SunlightState::DAY && !getSquare()->hasSunlightBlockingGasAmount();
+      getGame()->getSunlightInfo().getState() == SunlightState::DAY && !level->tileGas->hasSunlightBlockingAmount(coord);
 }
 
 double Position::getLightEmission() const {
@@ -1147,7 +1164,7 @@ optional<DestroyAction> Position::getBestDestroyAction(const MovementType& movem
 }
 
 double Position::getNavigationCost(const MovementType& movement, const Sectors& onltMovementSectors) const {
-  PROFILE;
+  PROFILE_HOT;
   if (onltMovementSectors.contains(coord)) {
     if (level->getSafeSquare(coord)->getCreature()) {
       return 5.0;
@@ -1156,7 +1173,7 @@ double Position::getNavigationCost(const MovementType& movement, const Sectors&
   }
   if (auto destroyAction = getBestDestroyAction(movement))
     return 1.0 + *getFurniture(FurnitureLayer::MIDDLE)->getStrength(*destroyAction) / 10;
-  if (movement.canBuildBridge() && canConstruct(FurnitureType("BRIDGE")) &&
+  if (movement.canBuildBridge() && canConstruct(bridgeType) &&
       !movement.isCompatible(getFurniture(FurnitureLayer::GROUND)->getTribe()))
     return 10;
   return ShortestPath::infinity;
@@ -1168,13 +1185,13 @@ bool Position::canNavigate(const MovementType& type) const {
 }
 
 bool Position::canNavigateCalc(const MovementType& type) const {
-  PROFILE;
+  PROFILE_HOT;
   optional<FurnitureLayer> ignore;
   if (auto furniture = getFurniture(FurnitureLayer::MIDDLE))
     for (DestroyAction action : type.getDestroyActions())
       if (furniture->canDestroy(*this, type, action))
         ignore = FurnitureLayer::MIDDLE;
-  if (type.canBuildBridge() && canConstruct(FurnitureType("BRIDGE")) &&
+  if (type.canBuildBridge() && canConstruct(bridgeType) &&
       !type.isCompatible(getFurniture(FurnitureLayer::GROUND)->getTribe()))
     return true;
   return canEnterEmptyCalc(type, ignore);
@@ -1198,7 +1215,7 @@ bool Position::canSeeThru(VisionId id, const ContentFactory* factory) const {
   if (!isValid() || !canSeeThruIgnoringGas(id))
     return false;
   for (auto& type : factory->tileGasTypes)
-    if (type.second.blocksVision && getSquare()->getGasAmount(type.first) >= TileGas::getFogVisionCutoff())
+    if (type.second.blocksVision && level->tileGas->getAmount(coord, type.first) >= TileGas::getFogVisionCutoff())
       return false;
   return true;
 }
@@ -1223,7 +1240,7 @@ bool Position::canSee(Position other, const Vision& vision) const {
 void Position::clearItemIndex(ItemIndex index) const {
   PROFILE;
   if (isValid())
-    modSquare()->clearItemIndex(index);
+    modSquare()->clearItemIndex(*this, index);
 }
 
 bool Position::isConnectedTo(Position pos, const MovementType& movement) const {
@@ -135,6 +135,8 @@ class Position {
   void clearItemIndex(ItemIndex) const;
   bool isConnectedTo(Position, const MovementType&) const;
   void updateMovementDueToFire() const;
+  /** Updates the onFire flag of this square only. See updateMovementDueToFire().*/
+  void updateOnFire() const;
   vector<Creature*> getAllCreatures(int range) const;
   void moveCreature(Vec2 direction);
   void moveCreature(Position, bool teleportEffect = false);
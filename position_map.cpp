@@ -10,62 +10,93 @@
 #include "construction_map.h"
 #include "zones.h"
 
-template <typename T>
-static optional<T&> getReferenceOptional(heap_optional<T>& t) {
-  if (t)
-    return *t;
-  else
-    return none;
+template <class T>
+const typename PositionMap<T>::LevelGrid* PositionMap<T>::getGrid(LevelId id) const {
+  for (auto& grid : levels)
+    if (grid.levelId == id)
+      return &grid;
+  return nullptr;
 }
 
-template <typename T>
-static optional<const T&> getReferenceOptional(const heap_optional<T>& t) {
-  if (t)
-    return *t;
-  else
-    return none;
+template <class T>
+typename PositionMap<T>::LevelGrid* PositionMap<T>::getGrid(LevelId id) {
+  for (auto& grid : levels)
+    if (grid.levelId == id)
+      return &grid;
+  return nullptr;
 }
 
 template <class T>
-optional<const T&> PositionMap<T>::getReferenceMaybe(Position pos) const {
+typename PositionMap<T>::LevelGrid& PositionMap<T>::getOrInitGrid(Position pos) {
   LevelId levelId = pos.getLevel()->getUniqueId();
+  if (auto ret = getGrid(levelId))
+    return *ret;
+  return addGrid(levelId, pos.getLevel()->getBounds().minusMargin(-2));
+}
+
+template <class T>
+typename PositionMap<T>::LevelGrid& PositionMap<T>::addGrid(LevelId levelId, Rectangle bounds) {
+  auto chunkBounds = Rectangle((bounds.width() + chunkSize - 1) / chunkSize, (bounds.height() + chunkSize - 1) / chunkSize);
+  levels.push_back(LevelGrid{levelId, bounds, Table<int>(chunkBounds, -1), {}, {}});
+  return levels.back();
+}
 
-  auto tableIter = tables.find(levelId);
-  if (tableIter != tables.end()) {
-    const auto& table = tableIter->second;
+template <class T>
+const optional<T>* PositionMap<T>::getElem(const LevelGrid& grid, Vec2 v) {
+  v -= grid.bounds.topLeft();
+  int index = grid.chunkIndex[v / chunkSize];
+  if (index == -1)
+    return nullptr;
+  return &grid.chunks[index].elems[(v.x % chunkSize) + (v.y % chunkSize) * chunkSize];
+}
+
+template <class T>
+optional<T>* PositionMap<T>::getElem(LevelGrid& grid, Vec2 v) {
+  return const_cast<optional<T>*>(getElem(const_cast<const LevelGrid&>(grid), v));
+}
 
-    if (pos.getCoord().inRectangle(table.getBounds()))
-      return getReferenceOptional(table[pos.getCoord()]);
+template <class T>
+optional<T>& PositionMap<T>::getOrInitElem(LevelGrid& grid, Vec2 v) {
+  CHECK(v.inRectangle(grid.bounds));
+  v -= grid.bounds.topLeft();
+  int& index = grid.chunkIndex[v / chunkSize];
+  if (index == -1) {
+    index = grid.chunks.size();
+    grid.chunks.push_back(Chunk{vector<optional<T>>(chunkSize * chunkSize)});
+  }
+  return grid.chunks[index].elems[(v.x % chunkSize) + (v.y % chunkSize) * chunkSize];
+}
 
-    auto outliersIter = outliers.find(levelId);
-    if (outliersIter != outliers.end()) {
-      const auto& outlier = outliersIter->second;
-      auto innerIter = outlier.find(pos.getCoord());
-      if(innerIter != outlier.end())
-        return innerIter->second;
+template <class T>
+optional<const T&> PositionMap<T>::getReferenceMaybe(Position pos) const {
+  if (auto grid = getGrid(pos.getLevel()->getUniqueId())) {
+    auto coord = pos.getCoord();
+    if (!coord.inRectangle(grid->bounds)) {
+      auto it = grid->outliers.find(coord);
+      if (it != grid->outliers.end())
+        return it->second;
+      return none;
     }
+    if (auto elem = getElem(*grid, coord))
+      if (*elem)
+        return **elem;
   }
   return none;
 }
 
 template <class T>
 optional<T&> PositionMap<T>::getReferenceMaybe(Position pos) {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-
-  auto tableIter = tables.find(levelId);
-  if (tableIter != tables.end()) {
-    auto& table = tableIter->second;
-
-    if (pos.getCoord().inRectangle(table.getBounds()))
-      return getReferenceOptional(table[pos.getCoord()]);
-
-    auto outliersIter = outliers.find(levelId);
-    if (outliersIter != outliers.end()) {
-      auto& outlier = outliersIter->second;
-      auto innerIter = outlier.find(pos.getCoord());
-      if(innerIter != outlier.end())
-        return innerIter->second;
+  if (auto grid = getGrid(pos.getLevel()->getUniqueId())) {
+    auto coord = pos.getCoord();
+    if (!coord.inRectangle(grid->bounds)) {
+      auto it = grid->outliers.find(coord);
+      if (it != grid->outliers.end())
+        return it->second;
+      return none;
     }
+    if (auto elem = getElem(*grid, coord))
+      if (*elem)
+        return **elem;
   }
   return none;
 }
@@ -83,69 +114,50 @@ bool PositionMap<T>::contains(Position pos) const {
   return !!getReferenceMaybe(pos);
 }
 
-template <class T>
-Table<heap_optional<T>>& PositionMap<T>::getTable(Position pos) {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  if (auto ret = ::getReferenceMaybe(tables, levelId))
-    return *ret;
-  else {
-    auto it = tables.insert(make_pair(levelId, Table<heap_optional<T>>(pos.getLevel()->getBounds().minusMargin(-2))));
-    return it.first->second;
-  }
-}
-
 template <class T>
 T& PositionMap<T>::getOrInit(Position pos) {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  auto& table = getTable(pos);
-  if (pos.getCoord().inRectangle(table.getBounds())) {
-    if (!table[pos.getCoord()])
-      table[pos.getCoord()] = T();
-    return *table[pos.getCoord()];
+  auto& grid = getOrInitGrid(pos);
+  if (pos.getCoord().inRectangle(grid.bounds)) {
+    auto& elem = getOrInitElem(grid, pos.getCoord());
+    if (!elem)
+      elem = T();
+    return *elem;
   }
-  return outliers[levelId][pos.getCoord()];
+  return grid.outliers[pos.getCoord()];
 }
 
 template <class T>
 T& PositionMap<T>::getOrFail(Position pos) {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  auto& table = tables.at(levelId);
-  if (pos.getCoord().inRectangle(table.getBounds()))
-    return *table[pos.getCoord()];
-  else
-    return outliers.at(levelId).at(pos.getCoord());
+  auto ret = getReferenceMaybe(pos);
+  CHECK(!!ret);
+  return *ret;
 }
 
 template <class T>
 const T& PositionMap<T>::getOrFail(Position pos) const {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  auto& table = tables.at(levelId);
-  if (pos.getCoord().inRectangle(table.getBounds()))
-    return *table[pos.getCoord()];
-  else
-    return outliers.at(levelId).at(pos.getCoord());
+  auto ret = getReferenceMaybe(pos);
+  CHECK(!!ret);
+  return *ret;
 }
 
 template <class T>
 void PositionMap<T>::set(Position pos, const T& elem) {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  auto& table = getTable(pos);
-  if (pos.getCoord().inRectangle(table.getBounds()))
-    table[pos.getCoord()] = elem;
+  auto& grid = getOrInitGrid(pos);
+  if (pos.getCoord().inRectangle(grid.bounds))
+    getOrInitElem(grid, pos.getCoord()) = elem;
   else
-    outliers[levelId][pos.getCoord()] = elem;
+    grid.outliers[pos.getCoord()] = elem;
 }
 
 template<class T>
 void PositionMap<T>::erase(Position pos) {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  if (auto table = ::getReferenceMaybe(tables, levelId))
-    if (pos.getCoord().inRectangle(table->getBounds()))
-      (*table)[pos.getCoord()] = none;
-  if (auto out = ::getReferenceMaybe(outliers, levelId))
-    if (auto elem = ::getReferenceMaybe(*out, pos.getCoord()))
-      elem = none;
-
+  if (auto grid = getGrid(pos.getLevel()->getUniqueId())) {
+    if (pos.getCoord().inRectangle(grid->bounds)) {
+      if (auto elem = getElem(*grid, pos.getCoord()))
+        *elem = none;
+    } else
+      grid->outliers.erase(pos.getCoord());
+  }
 }
 
 template <class T>
@@ -153,23 +165,38 @@ void PositionMap<T>::limitToModel(const Model* m) {
   std::set<LevelId> goodIds;
   for (Level* l : m->getLevels())
     goodIds.insert(l->getUniqueId());
-  for (auto& elem : copyOf(tables))
-    if (!goodIds.count(elem.first))
-      tables.erase(elem.first);
-  for (auto& elem : copyOf(outliers))
-    if (!goodIds.count(elem.first))
-      outliers.erase(elem.first);
+  levels = levels.filter([&](const LevelGrid& grid) { return goodIds.count(grid.levelId); });
+}
+
+// Older saves kept a full table of heap allocated values per level.
+template <class T>
+template <class Archive>
+void PositionMap<T>::serializeLegacy(Archive& ar1) {
+  map<LevelId, Table<heap_optional<T>>> tables;
+  map<LevelId, map<Vec2, T>> outliers;
+  ar1(tables, outliers);
+  for (auto& table : tables) {
+    auto& grid = addGrid(table.first, table.second.getBounds());
+    for (auto v : grid.bounds)
+      if (table.second[v])
+        getOrInitElem(grid, v) = std::move(*table.second[v]);
+    if (auto elems = ::getReferenceMaybe(outliers, table.first))
+      grid.outliers = std::move(*elems);
+  }
 }
 
 template <class T>
 template <class Archive>
 void PositionMap<T>::serialize(Archive& ar, const unsigned int version) {
-  ar(tables, outliers);
+  if (version < 1)
+    serializeLegacy(ar);
+  else
+    ar(levels);
 }
 
 template <class T>
 bool PositionMap<T>::containsLevel(const Level* l) const {
-  return tables.count(l->getUniqueId()) || outliers.count(l->getUniqueId());
+  return !!getGrid(l->getUniqueId());
 }
 
 template <class T>
@@ -23,8 +23,36 @@ class PositionMap {
   SERIALIZATION_DECL(PositionMap)
 
   private:
-  Table<heap_optional<T> >& getTable(Position);
-  map<LevelId, Table<heap_optional<T>>> SERIAL(tables);
-  map<LevelId, map<Vec2, T>> SERIAL(outliers);
+  // Values are kept inline in square chunks that are only allocated once something is stored in them,
+  // so large, mostly unexplored levels cost little more than the chunk directory.
+  static constexpr int chunkSize = 16;
+  struct Chunk {
+    vector<optional<T>> SERIAL(elems);
+    SERIALIZE_ALL(elems)
+  };
+  struct LevelGrid {
+    LevelId SERIAL(levelId);
+    Rectangle SERIAL(bounds);
+    Table<int> SERIAL(chunkIndex);
+    vector<Chunk> SERIAL(chunks);
+    map<Vec2, T> SERIAL(outliers);
+    SERIALIZE_ALL(levelId, bounds, chunkIndex, chunks, outliers)
+  };
+  const LevelGrid* getGrid(LevelId) const;
+  LevelGrid* getGrid(LevelId);
+  LevelGrid& getOrInitGrid(Position);
+  LevelGrid& addGrid(LevelId, Rectangle bounds);
+  static const optional<T>* getElem(const LevelGrid&, Vec2);
+  static optional<T>* getElem(LevelGrid&, Vec2);
+  static optional<T>& getOrInitElem(LevelGrid&, Vec2);
+  // Small flat index, since a map rarely covers more than a handful of levels.
+  vector<LevelGrid> SERIAL(levels);
+  template <class Archive>
+  void serializeLegacy(Archive&);
 };
 
+namespace cereal { namespace detail {
+  template <class T> struct Version<PositionMap<T>> {
+    static const std::uint32_t version = 1;
+  };
+}}
@@ -40,11 +40,13 @@ void PositionMatching::removeMatch(Position pos) {
   if (auto match = matches.getValueMaybe(pos)) {
     reverseMatches.erase(*match);
     matches.erase(pos);
+    changedTargets.push_back(pos);
     //std::cout << "Removed match " << pos.getCoord() << " " << match->getCoord() << std::endl;
   }
   if (auto match = reverseMatches.getValueMaybe(pos)) {
     matches.erase(*match);
     reverseMatches.erase(pos);
+    changedTargets.push_back(*match);
     //std::cout << "Removed match " << pos.getCoord() << " " << match->getCoord() << std::endl;
   }
 }
@@ -58,9 +60,16 @@ void PositionMatching::setMatch(Position pos1, Position pos2) {
   removeMatch(pos2);
   matches.set(pos1, pos2);
   reverseMatches.set(pos2, pos1);
+  changedTargets.push_back(pos1);
   //std::cout << "Added match " << pos1.getCoord() << " " << pos2.getCoord() << std::endl;
 }
 
+vector<Position> PositionMatching::popChangedTargets() {
+  vector<Position> ret;
+  swap(ret, changedTargets);
+  return ret;
+}
+
 void PositionMatching::findPath(Position pos) {
   PositionSet visited;
   findPath(pos, visited, true);
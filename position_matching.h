@@ -11,6 +11,8 @@ class PositionMatching : public OwnedObject<PositionMatching> {
   void releaseTarget(Position);
   void addTarget(Position);
   void updateMovement(Position);
+  /** Returns the targets whose match changed since the last call.*/
+  vector<Position> popChangedTargets();
 
   template <typename Archive>
   void serialize(Archive&, const unsigned);
@@ -23,4 +25,5 @@ class PositionMatching : public OwnedObject<PositionMatching> {
   PositionSet SERIAL(targets);
   void setMatch(Position, Position);
   void removeMatch(Position);
+  vector<Position> changedTargets;
 };
@@ -18,55 +18,91 @@ void PrettyInputArchive::throwException(const StreamPosStack& positions, const s
   throw PrettyException{positionToString(positions) + message};
 }
 
-static bool contains(const vector<StreamChar>& a, const string& substring, int index) {
+// The preprocessing below runs either on plain characters, or on characters tagged with their source positions,
+// which are only needed for error messages.
+static char charOf(const StreamChar& c) {
+  return c.c;
+}
+
+static char charOf(char c) {
+  return c;
+}
+
+static StreamPosStack posOf(const StreamChar& c) {
+  return c.pos;
+}
+
+static StreamPosStack posOf(char) {
+  return StreamPosStack();
+}
+
+template <typename Elem>
+Elem makeElem(StreamPos, char);
+
+template <>
+StreamChar makeElem(StreamPos pos, char c) {
+  return StreamChar{{std::move(pos)}, c};
+}
+
+template <>
+char makeElem(StreamPos, char c) {
+  return c;
+}
+
+template <typename Elem>
+static bool contains(const vector<Elem>& a, const string& substring, int index) {
   if (a.size() - index < substring.size())
     return false;
   for (auto i = index; i < index + substring.size(); ++i)
-    if (a[i].c != substring[i - index])
+    if (charOf(a[i]) != substring[i - index])
       return false;
   return true;
 }
 
-static void eatWhitespace(const vector<StreamChar>& s, int& index) {
-  while (index < s.size() && isspace(s[index].c))
+template <typename Elem>
+static void eatWhitespace(const vector<Elem>& s, int& index) {
+  while (index < s.size() && isspace(charOf(s[index])))
     ++index;
 }
 
-void eatArgument(const vector<StreamChar>& s, int& index);
+template <typename Elem>
+void eatArgument(const vector<Elem>& s, int& index);
 
-static vector<StreamChar> subStream(const vector<StreamChar>& s, int index, int count) {
-  vector<StreamChar> ret;
+template <typename Elem>
+static vector<Elem> subStream(const vector<Elem>& s, int index, int count) {
+  vector<Elem> ret;
   ret.reserve(count);
   for (int i = index; i < index + count && i < s.size(); ++i)
     ret.push_back(s[i]);
   return ret;
 }
 
-static vector<vector<StreamChar>> parseArgs(const vector<StreamChar>& s, int& index) {
-  vector<vector<StreamChar>> ret;
+template <typename Elem>
+static vector<vector<Elem>> parseArgs(const vector<Elem>& s, int& index) {
+  vector<vector<Elem>> ret;
   eatWhitespace(s, index);
   if (index >= s.size())
     return ret;
-  if (s[index].c == '(') {
+  if (charOf(s[index]) == '(') {
     ++index;
     while (1) {
       eatWhitespace(s, index);
       optional<int> beginArg;
-      if (s[index].c != ')')
+      if (charOf(s[index]) != ')')
         beginArg = index;
       eatArgument(s, index);
       if (beginArg) {
         eatWhitespace(s, *beginArg);
         ret.push_back(subStream(s, *beginArg, index - *beginArg));
-        while (isspace(ret.back().back().c))
+        while (isspace(charOf(ret.back().back())))
           ret.back().pop_back();
       }
       if (index >= s.size())
         return ret;
-      if (s[index].c == ',')
+      if (charOf(s[index]) == ',')
         ++index;
       eatWhitespace(s, index);
-      if (s[index].c == ')') {
+      if (charOf(s[index]) == ')') {
         ++index;
         break;
       }
@@ -77,40 +113,43 @@ static vector<vector<StreamChar>> parseArgs(const vector<StreamChar>& s, int& in
   return ret;
 }
 
-string getString(const vector<StreamChar>& s) {
+template <typename Elem>
+string getString(const vector<Elem>& s) {
   string ret;
   ret.reserve(s.size());
   for (auto& elem : s)
-    ret += elem.c;
+    ret += charOf(elem);
   return ret;
 }
 
-void eatArgument(const vector<StreamChar>& s, int& index) {
+template <typename Elem>
+void eatArgument(const vector<Elem>& s, int& index) {
   while (1) {
     eatWhitespace(s, index);
-    if (s[index].c == '\"' && s[index - 1].c != '\\')
+    if (charOf(s[index]) == '\"' && charOf(s[index - 1]) != '\\')
       do {
         ++index;
-      } while (index < s.size() - 1 && (s[index].c != '\"' || s[index - 1].c == '\\'));
-    if (s[index].c == ')')
+      } while (index < s.size() - 1 && (charOf(s[index]) != '\"' || charOf(s[index - 1]) == '\\'));
+    if (charOf(s[index]) == ')')
       return;
-    if (s[index].c == '(')
+    if (charOf(s[index]) == '(')
       parseArgs(s, index);
     ++index;
     eatWhitespace(s, index);
-    if (index >= s.size() || s[index].c == ',') {
+    if (index >= s.size() || charOf(s[index]) == ',') {
       return;
     }
   }
 }
 
-optional<string> scanWord(const vector<StreamChar>& s, int& index) {
+template <typename Elem>
+optional<string> scanWord(const vector<Elem>& s, int& index) {
   string ret;
   int origIndex = index;
-  while (index < s.size() && isspace(s[index].c))
+  while (index < s.size() && isspace(charOf(s[index])))
     ++index;
-  while (index < s.size() && (isalnum(s[index].c) || s[index].c == '_'))
-    ret += s[index++].c;
+  while (index < s.size() && (isalnum(charOf(s[index])) || charOf(s[index]) == '_'))
+    ret += charOf(s[index++]);
   if (ret.empty()) {
     index = origIndex;
     return none;
@@ -118,42 +157,46 @@ optional<string> scanWord(const vector<StreamChar>& s, int& index) {
   return ret;
 }
 
-static optional<string> peekWord(const vector<StreamChar>& s, int index) {
+template <typename Elem>
+static optional<string> peekWord(const vector<Elem>& s, int index) {
   return scanWord(s, index);
 }
 
-static void replaceInStream(vector<StreamChar>& s, int index, int length, const vector<StreamChar>& content) {
+template <typename Elem>
+static void replaceInStream(vector<Elem>& s, int index, int length, const vector<Elem>& content) {
   s.erase(index, length);
   s.insert(index, content);
 }
 
-pair<PrettyInputArchive::DefsMap, vector<StreamChar>> PrettyInputArchive::parseDefs(const vector<StreamChar>& content) {
-  vector<StreamChar> ret;
+template <typename Elem>
+pair<PrettyInputArchive::DefsMap, vector<Elem>> PrettyInputArchive::parseDefs(const vector<Elem>& content) {
+  vector<Elem> ret;
+  ret.reserve(content.size());
   bool inQuote = false;
   optional<pair<pair<string, int>, DefInfo>> currentDef;
   DefsMap defs;
   for (int i = 0; i < content.size(); ++i) {
-    if (content[i].c == '"' && (i == 0 || content[i - 1].c != '\\'))
+    if (charOf(content[i]) == '"' && (i == 0 || charOf(content[i - 1]) != '\\'))
       inQuote = !inQuote;
     if (!inQuote && contains(content, "Def", i)) {
       if (!!currentDef)
-        throwException(content[i].pos, "Definition inside another definition is not allowed");
+        throwException(posOf(content[i]), "Definition inside another definition is not allowed");
       i += strlen("Def");
       if (auto name = scanWord(content, i)) {
         auto beforeArgs = i;
         auto args = parseArgs(content, i);
         if (i >= content.size())
-          throwException(content[beforeArgs].pos, "Couldn't parse macro arguments");
+          throwException(posOf(content[beforeArgs]), "Couldn't parse macro arguments");
         currentDef = make_pair(make_pair(*name, args.size()),
             DefInfo{ i, 0, args.transform([](auto& arg) { return getString(arg); } ) });
         if (defs.count({*name, args.size()}))
-          throwException(content[i].pos, *name + " defined more than once");
+          throwException(posOf(content[i]), *name + " defined more than once");
       } else
-        throwException(content[i].pos, "Definition name expected");
+        throwException(posOf(content[i]), "Definition name expected");
       while (i < content.size() && peekWord(content, i) != "End"_s)
         ++i;
       if (i >= content.size())
-        throwException(content[currentDef->second.begin].pos, "Definition lacks an End token");
+        throwException(posOf(content[currentDef->second.begin]), "Definition lacks an End token");
       currentDef->second.end = i;
       defs.insert(*currentDef);
       currentDef = none;
@@ -175,30 +218,44 @@ static void append(StreamPosStack& to, const StreamPosStack& from) {
       }
 }
 
-vector<StreamChar> PrettyInputArchive::preprocess(const vector<StreamChar>& content) {
+static void appendPos(StreamChar& to, const StreamChar& from) {
+  append(to.pos, from.pos);
+}
+
+static void appendPos(char&, char) {
+}
+
+template <typename Elem>
+vector<Elem> PrettyInputArchive::preprocess(const vector<Elem>& content) {
   bool inQuote = false;
   auto parseRes = parseDefs(content);
   auto& ret = parseRes.second;
   auto& defs = parseRes.first;
+  if (defs.empty())
+    return std::move(ret);
+  set<string> defNames;
+  for (auto& def : defs)
+    defNames.insert(def.first.first);
   for (int i = 0; i < ret.size(); ++i) {
-    if (ret[i].c == '"' && (i == 0 || ret[i - 1].c != '\\'))
+    if (charOf(ret[i]) == '"' && (i == 0 || charOf(ret[i - 1]) != '\\'))
       inQuote = !inQuote;
     if (!inQuote) {
       auto beginCall = i;
-      if (auto name = scanWord(ret, i)) {
+      auto name = scanWord(ret, i);
+      if (name && defNames.count(*name)) {
         int argsPos = i;
         auto args = parseArgs(ret, argsPos);
         if (auto def = getReferenceMaybe(defs, make_pair(*name, args.size()))) {
           if (args.size() != def->args.size())
-            throwException(ret[argsPos].pos, "Wrong number of arguments to macro " + *name);
+            throwException(posOf(ret[argsPos]), "Wrong number of arguments to macro " + *name);
           auto body = subStream(content, def->begin, def->end - def->begin);
           for (auto& elem : body)
-            append(elem.pos, ret[i].pos);
+            appendPos(elem, ret[i]);
           for (int argNum : All(args)) {
             bool bodyInQuote = false;
             for (int bodyIndex = 0; bodyIndex < body.size(); ++bodyIndex) {
               const auto started = bodyIndex;
-              if (body[bodyIndex].c == '"' && (bodyIndex == 0 || body[bodyIndex - 1].c != '\\'))
+              if (charOf(body[bodyIndex]) == '"' && (bodyIndex == 0 || charOf(body[bodyIndex - 1]) != '\\'))
                 bodyInQuote = !bodyInQuote;
               eatWhitespace(body, bodyIndex);
               const auto beginOccurrence = bodyIndex;
@@ -218,13 +275,13 @@ vector<StreamChar> PrettyInputArchive::preprocess(const vector<StreamChar>& cont
   }
   /*if (!defs.empty())
     std::cout << "Replaced\n" << getString(ret) << "\nEnd replaced\n";*/
-  return ret;
+  return std::move(ret);
 }
 
-vector<StreamChar> removeFormatting(string contents, signed char filename) {
-  vector<StreamChar> ret;
+template <typename Elem>
+static void removeFormatting(vector<Elem>& ret, const string& contents, signed char filename) {
   auto addChar = [&ret] (StreamPos pos, char c) {
-    ret.push_back(StreamChar{{std::move(pos)}, c});
+    ret.push_back(makeElem<Elem>(std::move(pos), c));
   };
   StreamPos cur {filename, 1, 1};
   bool inQuote = false;
@@ -257,27 +314,192 @@ vector<StreamChar> removeFormatting(string contents, signed char filename) {
     } else
       ++cur.column;
   }
-  return ret;
 }
 
 static KeyVerifier dummyKeyVerifier;
 
-PrettyInputArchive::PrettyInputArchive(const vector<string>& inputs, const vector<string>& filenames, KeyVerifier* v)
-  : keyVerifier(v ? *v : dummyKeyVerifier), filenames(filenames) {
-  vector<StreamChar> allInput;
+template <typename Elem>
+vector<Elem> PrettyInputArchive::readInputs() {
+  vector<Elem> allInput;
+  int totalSize = 4;
+  for (auto& input : inputs)
+    totalSize += input.size();
+  allInput.reserve(totalSize + totalSize / 4);
   if (!filenames.empty()) {
-    allInput.push_back(StreamChar{{}, '{'});
-    allInput.push_back(StreamChar{{}, '\n'});
+    allInput.push_back(makeElem<Elem>(StreamPos{}, '{'));
+    allInput.push_back(makeElem<Elem>(StreamPos{}, '\n'));
   }
   for (int i = 0; i < inputs.size(); ++i)
-    allInput.append(removeFormatting(inputs[i], i < filenames.size() ? i : -1));
+    removeFormatting(allInput, inputs[i], i < filenames.size() ? i : -1);
   if (!filenames.empty()) {
-    allInput.push_back(StreamChar{{}, '\n'});
-    allInput.push_back(StreamChar{{}, '}'});
+    allInput.push_back(makeElem<Elem>(StreamPos{}, '\n'));
+    allInput.push_back(makeElem<Elem>(StreamPos{}, '}'));
   }
-  auto res = preprocess(allInput);
-  streamPos = res.transform([](auto& elem) { return elem.pos; });
-  is.str(getString(res));
+  return allInput;
+}
+
+PrettyInputArchive::PrettyInputArchive(const vector<string>& inputs, const vector<string>& filenames, KeyVerifier* v)
+  : keyVerifier(v ? *v : dummyKeyVerifier), filenames(filenames), inputs(inputs) {
+  try {
+    auto res = preprocess(readInputs<char>());
+    text.assign(res.begin(), res.end());
+  } catch (PrettyException) {
+    // Run again tracking positions, so that the error is reported where it happened.
+    preprocess(readInputs<StreamChar>());
+    throw;
+  }
+  tokenize();
+}
+
+// Positions are only needed for error messages, so they are computed by repeating the preprocessing
+// when the first error occurs.
+const vector<StreamPosStack>& PrettyInputArchive::getStreamPos() {
+  if (streamPos.empty() && !text.empty()) {
+    auto res = preprocess(readInputs<StreamChar>());
+    CHECK(res.size() == text.size());
+    streamPos.reserve(res.size());
+    for (auto& elem : res)
+      streamPos.push_back(elem.pos);
+  }
+  return streamPos;
+}
+
+void PrettyInputArchive::tokenize() {
+  for (int i = 0; i < text.size();) {
+    while (i < text.size() && isspace((unsigned char) text[i]))
+      ++i;
+    if (i == text.size())
+      break;
+    int begin = i;
+    while (i < text.size() && !isspace((unsigned char) text[i]))
+      ++i;
+    tokens.push_back(Token{begin, i});
+  }
+}
+
+optional<PrettyInputArchive::Token> PrettyInputArchive::nextToken(int pos) {
+  if (failed || atEof) {
+    failed = true;
+    return none;
+  }
+  auto isNext = [&](int index) {
+    return (index == tokens.size() || tokens[index].end > pos) && (index == 0 || tokens[index - 1].end <= pos);
+  };
+  if (!isNext(tokenHint)) {
+    if (tokenHint < tokens.size() && isNext(tokenHint + 1))
+      ++tokenHint;
+    else
+      tokenHint = std::upper_bound(tokens.begin(), tokens.end(), pos,
+          [](int pos, const Token& t) { return pos < t.end; }) - tokens.begin();
+  }
+  if (tokenHint == tokens.size()) {
+    failed = atEof = true;
+    return none;
+  }
+  return Token{max(pos, tokens[tokenHint].begin), tokens[tokenHint].end};
+}
+
+void PrettyInputArchive::setPosition(int pos) {
+  position = pos;
+  if (pos >= text.size())
+    atEof = true;
+}
+
+bool PrettyInputArchive::nextTokenIs(const char* s) {
+  if (failed)
+    return !*s;
+  auto token = nextToken(position);
+  atEof = false;
+  if (!token)
+    return !*s;
+  int length = token->end - token->begin;
+  return !strncmp(text.data() + token->begin, s, length) && s[length] == 0;
+}
+
+bool PrettyInputArchive::readValue(string& s) {
+  if (auto token = nextToken(position)) {
+    s.assign(text, token->begin, token->end - token->begin);
+    setPosition(token->end);
+    return true;
+  }
+  return false;
+}
+
+bool PrettyInputArchive::readQuoted(string& s) {
+  int c = getChar();
+  while (isspace(c))
+    c = getChar();
+  if (failed)
+    return false;
+  if (c != '"') {
+    --position;
+    return readValue(s);
+  }
+  s.clear();
+  while (true) {
+    c = getChar();
+    if (failed)
+      return false;
+    if (c == '\\') {
+      c = getChar();
+      if (failed)
+        return false;
+    } else if (c == '"')
+      break;
+    s += c;
+  }
+  return true;
+}
+
+// Fast path for the most common numeric token, the stream is used for everything else.
+optional<int> PrettyInputArchive::readSmallInteger(Token token) {
+  int index = token.begin;
+  bool negative = text[index] == '-';
+  if (negative)
+    ++index;
+  if (index == token.end || token.end - index > 9)
+    return none;
+  int ret = 0;
+  for (; index < token.end; ++index) {
+    if (!isdigit((unsigned char) text[index]))
+      return none;
+    ret = ret * 10 + text[index] - '0';
+  }
+  return negative ? -ret : ret;
+}
+
+int PrettyInputArchive::getChar() {
+  if (failed || atEof || position >= text.size()) {
+    failed = atEof = true;
+    return EOF;
+  }
+  return (unsigned char) text[position++];
+}
+
+int PrettyInputArchive::peekChar() {
+  if (failed || atEof) {
+    failed = true;
+    return EOF;
+  }
+  if (position >= text.size()) {
+    atEof = true;
+    return EOF;
+  }
+  return (unsigned char) text[position];
+}
+
+void PrettyInputArchive::clearFailure() {
+  failed = atEof = false;
+}
+
+PrettyInputArchive& PrettyInputArchive::readQuotedText(string& elem) {
+  auto b = bookmark();
+  if (!readQuoted(elem)) {
+    clearFailure();
+    seek(b);
+    error("Error reading value of type: "_s + typeid(decltype(std::quoted(elem))).name());
+  }
+  return *this;
 }
 
 static auto getOpenBracket(BracketType type) {
@@ -303,23 +525,20 @@ void PrettyInputArchive::closeBracket(BracketType type) {
 }
 
 bool PrettyInputArchive::isOpenBracket(BracketType type) {
-  return peek() == getOpenBracket(type);
+  return nextTokenIs(getOpenBracket(type));
 }
 
 bool PrettyInputArchive::isCloseBracket(BracketType type) {
-  return peek() == getCloseBracket(type);
+  return nextTokenIs(getCloseBracket(type));
 }
 
 string PrettyInputArchive::eat(const char* expected) {
   string s;
-  is >> s;
-  if (!is) {
-    if (is.eof())
+  if (!readValue(s)) {
+    if (atEof)
       error("Unexpected end of file");
-    if (is.fail())
-      error("Failure " + is.str());
-    if (is.bad())
-      error("IO Failure");
+    else
+      error("Failure " + text);
   }
   if (expected != nullptr && s != expected)
     error("Expected \""_s + expected + "\", got \"" + s + "\"");
@@ -327,8 +546,9 @@ string PrettyInputArchive::eat(const char* expected) {
 }
 
 StreamPosStack PrettyInputArchive::getCurrentPosition() {
-  int n = (int) is.tellg();
-  return streamPos.empty() ? StreamPosStack() : streamPos[max(0, min<int>(n, streamPos.size() - 1))];
+  int n = bookmark();
+  auto& positions = getStreamPos();
+  return positions.empty() ? StreamPosStack() : positions[max(0, min<int>(n, positions.size() - 1))];
 }
 
 void PrettyInputArchive::error(const string& s) {
@@ -336,7 +556,7 @@ void PrettyInputArchive::error(const string& s) {
 }
 
 bool PrettyInputArchive::eatMaybe(const string& s) {
-  if (peek() == s) {
+  if (nextTokenIs(s.data())) {
     eat();
     return true;
   } else
@@ -345,19 +565,34 @@ bool PrettyInputArchive::eatMaybe(const string& s) {
 
 string PrettyInputArchive::peek(int cnt) {
   string s;
-  auto bookmark = is.tellg();
-  for (int i : Range(cnt))
-    is >> s;
-  is.seekg(bookmark);
+  if (failed)
+    return s;
+  int pos = position;
+  for (int i : Range(cnt)) {
+    auto token = nextToken(pos);
+    if (!token)
+      break;
+    s.assign(text, token->begin, token->end - token->begin);
+    pos = token->end;
+  }
+  atEof = false;
   return s;
 }
 
 long PrettyInputArchive::bookmark() {
-  return is.tellg();
+  if (atEof)
+    failed = true;
+  return failed ? -1 : position;
 }
 
 void PrettyInputArchive::seek(long p) {
-  is.seekg(p);
+  atEof = false;
+  if (!failed) {
+    if (p < 0)
+      failed = true;
+    else
+      position = p;
+  }
 }
 
 void PrettyInputArchive::startNode() {
@@ -372,7 +607,7 @@ void PrettyInputArchive::endNode() {
 }
 
 void prettyEpilogue(PrettyInputArchive& ar1) {
-  auto loaders = ar1.getNode().loaders;
+  auto loaders = std::move(ar1.getNode().loaders);
   if (!loaders.empty()) {
     auto bracket = ar1.getNode().bracket;
     bool appending = ar1.eatMaybe("append") || ar1.getNode().inherited;
@@ -380,7 +615,7 @@ void prettyEpilogue(PrettyInputArchive& ar1) {
     bool keysAndValues = false;
     set<string> processed;
     while (!ar1.isCloseBracket(bracket)) {
-      if (ar1.peek() == ",")
+      if (ar1.nextTokenIs(","))
         ar1.eat();
       auto bookmark = ar1.bookmark();
       string name, equals;
@@ -407,7 +642,7 @@ void prettyEpilogue(PrettyInputArchive& ar1) {
             ar1.error("Value defined twice: \"" + name + "\"");
           processed.insert(name);
           bool initialize = true;
-          if (ar1.peek() == "append") {
+          if (ar1.nextTokenIs("append")) {
             if (!appending)
               ar1.error("Can't append to value that wasn't inherited");
             initialize = false;
@@ -435,7 +670,7 @@ void serialize(PrettyInputArchive& ar, string& t) {
     string tmp = ar.peek();
     if (isdigit(tmp[0])) {
       int value;
-      ar.is >> value;
+      ar.readValue(value);
       t += toString(value);
       if (!ar.eatMaybe("+"))
         break;
@@ -443,7 +678,7 @@ void serialize(PrettyInputArchive& ar, string& t) {
       if (tmp[0] != '\"')
         ar.error("Expected quoted string, got: " + tmp);
       string next;
-      ar.readText(std::quoted(next));
+      ar.readQuotedText(next);
       t += next;
       if (!ar.eatMaybe("+"))
         break;
@@ -453,7 +688,7 @@ void serialize(PrettyInputArchive& ar, string& t) {
 
 void serialize(PrettyInputArchive& ar, char& c) {
   string s;
-  ar.readText(std::quoted(s));
+  ar.readQuotedText(s);
   if (s[0] == '0')
     c = '\0';
   else
@@ -505,20 +740,20 @@ struct Expression {
   char pop() {
     char c = ' ';
     while (isspace(c))
-      c = ar.is.get();
+      c = ar.getChar();
     return c;
   }
 
   char peek() {
-    while (isspace(ar.is.peek()))
-      ar.is.get();
-    return ar.is.peek();
+    while (isspace(ar.peekChar()))
+      ar.getChar();
+    return ar.peekChar();
   }
 
   int factor() {
     if (isdigit(peek()) || peek() == '-') {
-      int result;
-      ar.is >> result;
+      int result = 0;
+      ar.readValue(result);
       return result;
     } else
     if (peek() == '(') {
@@ -55,9 +55,8 @@ class PrettyInputArchive {
     template <typename T>
     bool readMaybe(T& elem) {
       auto b = bookmark();
-      is >> elem;
-      if (!is) {
-        is.clear();
+      if (!readValue(elem)) {
+        clearFailure();
         seek(b);
         return false;
       }
@@ -72,17 +71,18 @@ class PrettyInputArchive {
     string peek(int cnt = 1);
 
     template <typename T>
-    PrettyInputArchive& readText(T&& elem) {
+    PrettyInputArchive& readText(T& elem) {
       auto b = bookmark();
-      is >> std::forward<T>(elem);
-      if (!is) {
-        is.clear();
+      if (!readValue(elem)) {
+        clearFailure();
         seek(b);
         error("Error reading value of type: "_s + typeid(T).name());
       }
       return *this;
     }
 
+    PrettyInputArchive& readQuotedText(string& elem);
+
     long bookmark();
 
     template <typename T>
@@ -121,17 +121,72 @@ class PrettyInputArchive {
     using is_loading = std::true_type;
     using is_saving = std::false_type;
 
+    // The preprocessed input is split once into whitespace separated tokens, which are then walked by
+    // character position. Most reads start at a token boundary, so the lookup is usually a single step.
+    struct Token {
+      int begin;
+      int end;
+    };
+    // These mimic extracting from a std::istream positioned at the given character, including the sticky
+    // failure state, so that positions reported in error messages stay the same.
+    bool readValue(string&);
+    bool readQuoted(string&);
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value, bool>::type readValue(T& elem) {
+      auto token = nextToken(position);
+      if (!token)
+        return false;
+      if (std::is_integral<T>::value && sizeof(T) >= sizeof(int))
+        if (auto value = readSmallInteger(*token)) {
+          elem = T(*value);
+          setPosition(token->end);
+          return true;
+        }
+      numberStream.clear();
+      numberStream.str(text.substr(token->begin, token->end - token->begin));
+      numberStream >> elem;
+      if (!numberStream) {
+        failed = true;
+        return false;
+      }
+      if (numberStream.eof())
+        setPosition(token->end);
+      else
+        setPosition(token->begin + (int) numberStream.tellg());
+      return true;
+    }
+    optional<int> readSmallInteger(Token);
+    int getChar();
+    int peekChar();
+    void clearFailure();
+
     //private:
     vector<NodeData> nodeData;
     bool nextElemInherited = false;
-    std::istringstream is;
+    string text;
+    vector<Token> tokens;
+    int position = 0;
+    int tokenHint = 0;
+    bool failed = false;
+    bool atEof = false;
+    std::istringstream numberStream;
+    optional<Token> nextToken(int pos);
+    bool nextTokenIs(const char*);
+    void setPosition(int);
+    void tokenize();
     vector<StreamPosStack> streamPos;
     vector<string> filenames;
     void throwException(const StreamPosStack&, const string&);
     string positionToString(const StreamPosStack&);
     using DefsMap = map<pair<string, int>, DefInfo>;
-    pair<DefsMap, vector<StreamChar>> parseDefs(const vector<StreamChar>& content);
-    vector<StreamChar> preprocess(const vector<StreamChar>& content);
+    template <typename Elem>
+    pair<DefsMap, vector<Elem>> parseDefs(const vector<Elem>& content);
+    template <typename Elem>
+    vector<Elem> preprocess(const vector<Elem>& content);
+    template <typename Elem>
+    vector<Elem> readInputs();
+    vector<string> inputs;
+    const vector<StreamPosStack>& getStreamPos();
 };
 
 template<typename T, typename int_<decltype(serialize(std::declval<PrettyInputArchive&>(), std::declval<T&>()))>::type = 0>
@@ -295,7 +350,7 @@ inline void serializeMap(PrettyInputArchive& ar1, M& m) {
       break;
     typename M::key_type key;
     ar1(key);
-    if (ar1.peek() != "modify" && keys.count(key))
+    if (!ar1.nextTokenIs("modify") && keys.count(key))
       ar1.error("Duplicate key");
     keys.insert(key);
     typename M::mapped_type value;
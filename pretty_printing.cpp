@@ -72,9 +72,46 @@ optional<string> PrettyPrinting::parseObject(T& object, const vector<string>& s,
   }
 }
 
+PrettyPrinting::PreparedInput::PreparedInput(unique_ptr<PrettyInputArchive> a) : archive(std::move(a)) {}
+PrettyPrinting::PreparedInput::PreparedInput(string e) : error(std::move(e)) {}
+PrettyPrinting::PreparedInput::PreparedInput(PreparedInput&&) noexcept = default;
+PrettyPrinting::PreparedInput& PrettyPrinting::PreparedInput::operator = (PreparedInput&&) = default;
+PrettyPrinting::PreparedInput::~PreparedInput() {}
+
+PrettyPrinting::PreparedInput PrettyPrinting::prepareInput(const vector<FilePath>& paths, KeyVerifier* keyVerifier) {
+  vector<string> allContent;
+  vector<string> pathStrings;
+  for (auto& path : paths) {
+    pathStrings.push_back(path.getPath());
+    if (auto contents = path.readContents())
+      allContent.push_back(*contents);
+    else
+      return "Couldn't open file: "_s + path.getPath();
+  }
+  try {
+    return make_unique<PrettyInputArchive>(allContent, pathStrings, keyVerifier);
+  } catch (PrettyException ex) {
+    return ex.text;
+  }
+}
+
+template <typename T>
+optional<string> PrettyPrinting::parseObject(T& object, PreparedInput input) {
+  if (input.error)
+    return input.error;
+  try {
+    (*input.archive)(object);
+    return none;
+  } catch (PrettyException ex) {
+    return ex.text;
+  }
+}
+
 #define ADD_IMP(...) \
 template \
-optional<string> PrettyPrinting::parseObject<__VA_ARGS__>(__VA_ARGS__&, const vector<string>&, vector<string>, KeyVerifier*);
+optional<string> PrettyPrinting::parseObject<__VA_ARGS__>(__VA_ARGS__&, const vector<string>&, vector<string>, KeyVerifier*);\
+template \
+optional<string> PrettyPrinting::parseObject<__VA_ARGS__>(__VA_ARGS__&, PreparedInput);
 
 ADD_IMP(Effect)
 ADD_IMP(ItemType)
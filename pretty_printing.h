@@ -7,12 +7,30 @@
 class Effect;
 class ItemType;
 class KeyVerifier;
+class PrettyInputArchive;
 
 class PrettyPrinting {
   public:
   template<typename T>
   static optional<string> parseObject(T& object, const vector<string>&, vector<string> filename = {}, KeyVerifier* keyVerifier = nullptr);
 
+  // Input files that were read and preprocessed, which doesn't touch any global state, so it can be done
+  // on a worker thread ahead of the actual parsing.
+  struct PreparedInput {
+    PreparedInput(unique_ptr<PrettyInputArchive>);
+    PreparedInput(string error);
+    PreparedInput(PreparedInput&&) noexcept;
+    PreparedInput& operator = (PreparedInput&&);
+    ~PreparedInput();
+    unique_ptr<PrettyInputArchive> archive;
+    optional<string> error;
+  };
+
+  static PreparedInput prepareInput(const vector<FilePath>& paths, KeyVerifier*);
+
+  template<typename T>
+  static optional<string> parseObject(T& object, PreparedInput);
+
   template<typename T>
   static optional<string> parseObject(T& object, const string& text) {
     return parseObject(object, vector<string>(1, text));
@@ -20,15 +38,6 @@ class PrettyPrinting {
 
   template<typename T>
   static optional<string> parseObject(T& object, vector<FilePath> paths, KeyVerifier* keyVerifier) {
-    vector<string> allContent;
-    vector<string> pathStrings;
-    for (auto& path : paths) {
-      pathStrings.push_back(path.getPath());
-      if (auto contents = path.readContents())
-        allContent.push_back(*contents);
-      else
-        return "Couldn't open file: "_s + path.getPath();
-    }
-    return PrettyPrinting::parseObject<T>(object, allContent, pathStrings, keyVerifier);
+    return PrettyPrinting::parseObject<T>(object, prepareInput(paths, keyVerifier));
   }
 };
@@ -1,13 +1,19 @@
 #pragma once
 
+// PROFILE_HOT is PROFILE for functions on hot paths, eg. pathfinding. check_hot_paths.sh fails if
+// such a function constructs a ContentId from a string literal; use ContentIdConstant instead.
+
 #ifdef EASY_PROFILER
 #define BUILD_WITH_EASY_PROFILER
 
 #include <easy/profiler.h>
+#include <easy/arbitrary_value.h>
 
 
 #define PROFILE EASY_FUNCTION(__LINE__)
+#define PROFILE_HOT PROFILE
 #define PROFILE_BLOCK(...) EASY_BLOCK(__VA_ARGS__)
+#define PROFILE_VALUE(name, value) EASY_VALUE(name, value)
 
 #define ENABLE_PROFILER\
   profiler::startListen()
@@ -17,7 +23,9 @@
 #else
 
 #define PROFILE
+#define PROFILE_HOT
 #define PROFILE_BLOCK(...)
+#define PROFILE_VALUE(name, value)
 #define ENABLE_PROFILER
 
 #endif
@@ -67,6 +67,22 @@ class ReadWriteArray {
     readonly[pos] = -1;
   }
 
+  struct Slot {
+    int modified;
+    short readonly;
+    optional<Param> type;
+  };
+
+  Slot getSlot(Vec2 pos) const {
+    return Slot{modified[pos], readonly[pos], types[pos]};
+  }
+
+  void setSlot(Vec2 pos, const Slot& slot) {
+    modified[pos] = slot.modified;
+    readonly[pos] = slot.readonly;
+    types[pos] = slot.type;
+  }
+
   int getNumGenerated() const {
     return allModified.size() + readonlyMap.size();
   }
@@ -428,3 +428,26 @@ const BfSearch::ReachableSet& BfSearch::getAllReachable() const {
   return reachable;
 }
 
+void ConnectSearch::reset(Rectangle b) {
+  bounds = b;
+  int size = bounds.width() * bounds.height();
+  inTree.clear();
+  inTree.resize(size);
+  treeQueue.clear();
+  visited.resize(size);
+  distance.resize(size);
+  entryCost.resize(size);
+  parent.resize(size);
+}
+
+void ConnectSearch::addToTree(Vec2 v) {
+  auto index = getIndex(v);
+  if (!inTree[index]) {
+    inTree[index] = 1;
+    treeQueue.push_back(index);
+  }
+}
+
+bool ConnectSearch::isInTree(Vec2 v) const {
+  return inTree[getIndex(v)];
+}
@@ -117,3 +117,111 @@ class BfSearch {
   ReachableSet reachable;
 };
 
+/** Joins targets one at a time into a single tree over a cost grid. Each search starts at the new target
+    and stops at the first tree square it reaches, so connecting many targets costs roughly as much as
+    growing one search tree. The buffers are kept between searches and between calls to reset().*/
+class ConnectSearch {
+  public:
+  void reset(Rectangle bounds);
+  void addToTree(Vec2);
+  bool isInTree(Vec2) const;
+
+  /** Adds to the tree all squares accepted by the predicate that are reachable from the tree through
+      such squares. Only squares added since the last call are expanded.*/
+  template <typename Predicate>
+  void growTree(Predicate, const vector<Vec2>& directions);
+
+  /** Returns the cheapest path from the tree to the target, in order from the square next to the tree up
+      to the target, or none if the tree can't be reached or the target itself can't be entered.
+      Entering a tree square costs nothing.
+      The path isn't added to the tree.*/
+  template <typename EntryFun>
+  optional<vector<Vec2>> connect(Vec2 target, EntryFun entryFun, const vector<Vec2>& directions);
+
+  private:
+  int getIndex(Vec2) const;
+  Vec2 getPos(int index) const;
+  Rectangle bounds = Rectangle(0, 0);
+  vector<char> inTree;
+  vector<int> treeQueue;
+  vector<int> visited;
+  vector<double> distance;
+  vector<double> entryCost;
+  vector<int> parent;
+  vector<pair<double, int>> heap;
+  int generation = 0;
+};
+
+inline int ConnectSearch::getIndex(Vec2 v) const {
+  return (v.x - bounds.left()) + (v.y - bounds.top()) * bounds.width();
+}
+
+inline Vec2 ConnectSearch::getPos(int index) const {
+  return Vec2(bounds.left() + index % bounds.width(), bounds.top() + index / bounds.width());
+}
+
+template <typename Predicate>
+void ConnectSearch::growTree(Predicate predicate, const vector<Vec2>& directions) {
+  while (!treeQueue.empty()) {
+    auto pos = getPos(treeQueue.back());
+    treeQueue.pop_back();
+    for (auto dir : directions) {
+      auto next = pos + dir;
+      if (next.inRectangle(bounds) && !inTree[getIndex(next)] && predicate(next))
+        addToTree(next);
+    }
+  }
+}
+
+template <typename EntryFun>
+optional<vector<Vec2>> ConnectSearch::connect(Vec2 target, EntryFun entryFun, const vector<Vec2>& directions) {
+  CHECK(target.inRectangle(bounds));
+  if (isInTree(target))
+    return vector<Vec2>();
+  if (entryFun(target) >= ShortestPath::infinity)
+    return none;
+  ++generation;
+  heap.clear();
+  auto compare = [](const pair<double, int>& a, const pair<double, int>& b) { return a.first > b.first; };
+  auto start = getIndex(target);
+  visited[start] = generation;
+  distance[start] = 0;
+  parent[start] = -1;
+  heap.push_back({0, start});
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), compare);
+    auto elem = heap.back();
+    heap.pop_back();
+    int index = elem.second;
+    if (elem.first > distance[index])
+      continue;
+    if (inTree[index]) {
+      vector<Vec2> ret;
+      for (int i = parent[index]; i != -1; i = parent[i])
+        ret.push_back(getPos(i));
+      return ret;
+    }
+    auto pos = getPos(index);
+    for (auto dir : directions) {
+      auto next = pos + dir;
+      if (!next.inRectangle(bounds))
+        continue;
+      int nextIndex = getIndex(next);
+      if (visited[nextIndex] != generation) {
+        visited[nextIndex] = generation;
+        distance[nextIndex] = ShortestPath::infinity;
+        entryCost[nextIndex] = inTree[nextIndex] ? 0 : entryFun(next);
+      }
+      if (entryCost[nextIndex] >= ShortestPath::infinity)
+        continue;
+      double newDist = elem.first + entryCost[nextIndex];
+      if (newDist < distance[nextIndex]) {
+        distance[nextIndex] = newDist;
+        parent[nextIndex] = index;
+        heap.push_back({newDist, nextIndex});
+        std::push_heap(heap.begin(), heap.end(), compare);
+      }
+    }
+  }
+  return none;
+}
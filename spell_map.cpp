@@ -12,7 +12,13 @@
 #include "equipment.h"
 #include "item.h"
 
+int SpellMap::getNewVersion() {
+  static int lastVersion = 0;
+  return ++lastVersion;
+}
+
 void SpellMap::add(Spell spell, AttrType expType, int level) {
+  version = getNewVersion();
   for (auto& elem : elems)
     if (elem.spell.getId() == spell.getId()) {
       elem.level = min(elem.level, level);
@@ -35,6 +41,7 @@ void SpellMap::add(Spell spell, AttrType expType, int level) {
 }
 
 void SpellMap::remove(SpellId id) {
+  version = getNewVersion();
   for (int i = 0; i < elems.size(); ++i)
     if (elems[i].spell.getId() == id) {
       elems.removeIndexPreserveOrder(i);
@@ -87,22 +94,58 @@ void SpellMap::setReadyTime(const Creature* c, const Spell* spell, GlobalTime ti
     FATAL << "spell not found";*/
 }
 
+const vector<const Spell*>& SpellMap::getEquipmentAbilities(const Creature* c) const {
+  auto& equipment = c->getEquipment();
+  auto& items = equipment.getAllEquipped();
+  auto isValid = [&] {
+    auto& cache = *equipmentAbilityCache;
+    if (cache.equipment != &equipment || cache.equipmentVersion != equipment.getVersion() ||
+        cache.itemVersions.size() != items.size())
+      return false;
+    for (int i : All(items))
+      if (cache.itemVersions[i] != items[i]->getAbilityVersion())
+        return false;
+    return true;
+  };
+  if (!equipmentAbilityCache || !isValid()) {
+    EquipmentAbilityCache cache{&equipment, equipment.getVersion(), {}, {}};
+    for (auto it : items) {
+      cache.itemVersions.push_back(it->getAbilityVersion());
+      for (auto& a : it->getAbility())
+        cache.spells.push_back(&a.spell);
+    }
+    equipmentAbilityCache = std::move(cache);
+  }
+  return equipmentAbilityCache->spells;
+}
+
 vector<const Spell*> SpellMap::getAvailable(const Creature* c) const {
   PROFILE;
-  HashSet<SpellId> upgraded;
-  for (auto& elem : elems)
-    if (elem.level <= c->getAttributes().getExpLevel(elem.expType))
-      if (auto upgrade = elem.spell.getUpgrade())
-        upgraded.insert(*upgrade);
+  static long long numCalls = 0;
+  static long long numHits = 0;
+  ++numCalls;
+  auto expLevelVersion = c->getAttributes().getExpLevelVersion();
+  if (availableCache && availableCache->version == version && availableCache->expLevelVersion == expLevelVersion)
+    ++numHits;
+  else {
+    HashSet<SpellId> upgraded;
+    for (auto& elem : elems)
+      if (elem.level <= c->getAttributes().getExpLevel(elem.expType))
+        if (auto upgrade = elem.spell.getUpgrade())
+          upgraded.insert(*upgrade);
+    vector<int> indexes;
+    for (int i : All(elems))
+      if (elems[i].level <= c->getAttributes().getExpLevel(elems[i].expType)) {
+        if (!upgraded.count(elems[i].spell.getId()))
+          indexes.push_back(i);
+      }
+    availableCache = AvailableCache{version, expLevelVersion, std::move(indexes)};
+  }
+  PROFILE_VALUE("SpellMap::getAvailable cache hit rate", double(numHits) / numCalls);
   vector<const Spell*> ret;
-  for (auto& elem : elems)
-    if (elem.level <= c->getAttributes().getExpLevel(elem.expType)) {
-      if (!upgraded.count(elem.spell.getId()))
-        ret.push_back(&elem.spell);
-    }
-  for (auto it : c->getEquipment().getAllEquipped())
-    for (auto& a : it->getAbility())
-      ret.push_back(&a.spell);
+  for (int index : availableCache->indexes)
+    ret.push_back(&elems[index].spell);
+  ret.append(getEquipmentAbilities(c));
   return ret;
 }
 
@@ -22,6 +22,7 @@
 
 class Spell;
 struct ItemAbility;
+class Equipment;
 
 class SpellMap {
   public:
@@ -48,5 +49,24 @@ class SpellMap {
   vector<SpellInfo> SERIAL(elems);
   const SpellInfo* getInfo(SpellId) const;
   SpellInfo* getInfo(SpellId);
+  // Changes whenever elems is modified. Versions are unique among all spell maps, so a copy of the map can keep
+  // using the cache below.
+  int version = getNewVersion();
+  static int getNewVersion();
+  struct AvailableCache {
+    int version;
+    int expLevelVersion;
+    vector<int> indexes;
+  };
+  mutable optional<AvailableCache> availableCache;
+  // Abilities of the equipped items. Valid while neither the equipment nor any of the items' ability lists change.
+  struct EquipmentAbilityCache {
+    const Equipment* equipment;
+    int equipmentVersion;
+    vector<int> itemVersions;
+    vector<const Spell*> spells;
+  };
+  mutable optional<EquipmentAbilityCache> equipmentAbilityCache;
+  const vector<const Spell*>& getEquipmentAbilities(const Creature*) const;
 };
 
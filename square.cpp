@@ -34,13 +34,33 @@
 #include "furniture.h"
 #include "content_factory.h"
 #include "tile_gas_info.h"
+#include "model.h"
+
+// Loads saves in which every square stored its inventory and gas inline.
+template <class Archive>
+void Square::serializeLegacy(Archive& ar1) {
+  HeapAllocated<Inventory> oldInventory;
+  HeapAllocated<SquareGasAmounts> oldTileGas;
+  ar1(oldInventory, onFire);
+  ar1(creature, landingLink, oldTileGas);
+  ar1(lastViewer, viewIndex);
+  ar1(forbiddenTribe);
+  if (!oldInventory->isEmpty())
+    inventory = std::move(*oldInventory);
+  if (!oldTileGas->amount.empty())
+    legacyGas = std::move(*oldTileGas);
+}
 
 template <class Archive> 
 void Square::serialize(Archive& ar, const unsigned int version) { 
-  ar(inventory, onFire);
-  ar(creature, landingLink, tileGas);
-  ar(lastViewer, viewIndex);
-  ar(forbiddenTribe);
+  if (version < 1)
+    serializeLegacy(ar);
+  else {
+    ar(inventory, onFire);
+    ar(creature, landingLink);
+    ar(lastViewer, viewIndex);
+    ar(forbiddenTribe);
+  }
   if (progressMeter)
     progressMeter->addProgress();
 }
@@ -49,7 +69,7 @@ ProgressMeter* Square::progressMeter = nullptr;
 
 SERIALIZABLE(Square);
 
-Square::Square() : viewIndex(new ViewIndex()) {
+Square::Square() {
 }
 
 Square::~Square() {
@@ -79,15 +99,21 @@ optional<StairKey> Square::getLandingLink() const {
 }
 
 void Square::onAddedToLevel(Position pos) const {
-  if (!inventory->isEmpty())
+  if (inventory)
     pos.getLevel()->addTickingSquare(pos.getCoord());
 }
 
-void Square::tick(Position pos) {
+static void updateItemIndexes(Position pos) {
+  if (auto model = pos.getModel())
+    model->onItemsChanged(pos);
+}
+
+bool Square::tick(Position pos) {
   PROFILE_BLOCK("Square::tick");
   setDirty(pos);
-  if (!inventory->isEmpty()) {
-    inventory->tick(pos, false);
+  if (inventory) {
+    if (!inventory->tick(pos, false).empty())
+      updateItemIndexes(pos);
     if (!pos.canEnterEmpty(MovementType(MovementTrait::WALK).setForced()) ||
         (creature && creature->isAffected(LastingEffect::IMMOBILE)))
       for (auto neighbor : pos.neighbors8(Random))
@@ -95,8 +121,11 @@ void Square::tick(Position pos) {
           neighbor.dropItems(pos.removeItems(pos.getItems()));
           break;
         }
+    // Items can be removed during Inventory::tick(), so an empty inventory is only released here.
+    if (inventory->isEmpty())
+      inventory.clear();
   }
-  tileGas->tick(pos);
+  return !!inventory;
 }
 
 bool Square::itemLands(vector<Item*> item, const Attack& attack) const {
@@ -126,34 +155,18 @@ void Square::onItemLands(Position pos, vector<PItem> item, const Attack& attack)
     pos.dropItems(std::move(item));
 }
 
-void Square::addGas(Position pos, TileGasType type, double amount) {
-  setDirty(pos);
-  if (pos.canSeeThruIgnoringGas(VisionId::NORMAL)) {
-    tileGas->addAmount(pos, type, amount);
-    pos.getLevel()->addTickingSquare(pos.getCoord());
-  }
-}
-
-void Square::addPermanentGas(TileGasType type, double amount) {
-  tileGas->addPermanentAmount(type, amount);
-}
-
-double Square::getGasAmount(TileGasType type) const {
-  return tileGas->getAmount(type);
-}
-
-bool Square::hasSunlightBlockingGasAmount() const {
-  return tileGas->hasSunlightBlockingAmount();
+heap_optional<SquareGasAmounts> Square::takeLegacyGas() {
+  return std::move(legacyGas);
 }
 
 void Square::getViewIndex(const ContentFactory* factory, ViewIndex& ret, const Creature* viewer) const {
-  if ((!viewer && lastViewer) || (viewer && lastViewer == viewer->getUniqueId())) {
+  if (viewIndex && ((!viewer && lastViewer) || (viewer && lastViewer == viewer->getUniqueId()))) {
     ret = *viewIndex;
     return;
   }
   // viewer is null only in Spectator mode, so setting a random id to lastViewer is ok
   lastViewer = viewer ? viewer->getUniqueId() : Creature::Id();
-  ret.modItemCounts() = inventory->getCounts();
+  ret.modItemCounts() = getInventory().getCounts();
   if (!getInventory().isEmpty()) {
     auto obj = getInventory().getItems().back()->getViewObject();
     for (Item* it : getInventory().getItems())
@@ -164,11 +177,8 @@ void Square::getViewIndex(const ContentFactory* factory, ViewIndex& ret, const C
     ret.insert(std::move(obj));
   }
   CHECK(ret.getGasAmounts().empty());
-  for (auto& type : factory->tileGasTypes) {
-    auto amount = tileGas->getAmount(type.first);
-    if (amount > 0)
-      ret.addGasAmount(type.second.name, type.second.color.transparency(amount * 255));
-  }
+  if (!viewIndex)
+    viewIndex = make_unique<ViewIndex>();
   *viewIndex = ret;
 }
 
@@ -177,6 +187,8 @@ void Square::dropItem(Position pos, PItem item) {
 }
 
 void Square::dropItemsLevelGen(vector<PItem> items) {
+  if (!inventory)
+    inventory = Inventory();
   inventory->addItems(std::move(items));
 }
 
@@ -184,6 +196,7 @@ void Square::dropItems(Position pos, vector<PItem> items) {
   setDirty(pos);
   pos.getLevel()->addTickingSquare(pos.getCoord());
   dropItemsLevelGen(std::move(items));
+  updateItemIndexes(pos);
 }
 
 Creature* Square::getCreature() const {
@@ -202,14 +215,18 @@ PItem Square::removeItem(Position pos, Item* it) {
   setDirty(pos);
   for (auto f : pos.getFurniture())
     f->onItemsRemoved(pos);
-  return inventory->removeItem(it);
+  auto ret = inventory->removeItem(it);
+  updateItemIndexes(pos);
+  return ret;
 }
 
 vector<PItem> Square::removeItems(Position pos, vector<Item*> it) {
   setDirty(pos);
   for (auto f : pos.getFurniture())
     f->onItemsRemoved(pos);
-  return inventory->removeItems(it);
+  auto ret = inventory->removeItems(it);
+  updateItemIndexes(pos);
+  return ret;
 }
 
 void Square::setDirty(Position pos) {
@@ -240,9 +257,13 @@ optional<TribeId> Square::getForbiddenTribe() const {
 }
 
 const Inventory& Square::getInventory() const {
-  return *inventory;
+  static const Inventory empty;
+  return inventory ? *inventory : empty;
 }
 
-void Square::clearItemIndex(ItemIndex index) {
-  inventory->clearIndex(index);
+void Square::clearItemIndex(Position pos, ItemIndex index) {
+  if (inventory) {
+    inventory->clearIndex(index);
+    updateItemIndexes(pos);
+  }
 }
@@ -23,7 +23,7 @@
 class Creature;
 class Item;
 class ProgressMeter;
-class TileGas;
+struct SquareGasAmounts;
 class Inventory;
 class Position;
 class ViewIndex;
@@ -45,11 +45,6 @@ class Square {
   /** Returns the entry point details. Returns none if square is not entry point. See setLandingLink().*/
   optional<StairKey> getLandingLink() const;
 
-  void addGas(Position, TileGasType, double amount);
-  void addPermanentGas(TileGasType, double amount);
-  double getGasAmount(TileGasType) const;
-  bool hasSunlightBlockingGasAmount() const;
-
   /** Sets the level this square is on.*/
   void onAddedToLevel(Position) const;
 
@@ -73,8 +68,9 @@ class Square {
   //@}
 
   /** Triggers all time-dependent processes like burning. Calls tick() for items if present.
-      For this method to be called, the square coordinates must be added with Level::addTickingSquare().*/
-  void tick(Position);
+      For this method to be called, the square coordinates must be added with Level::addTickingSquare().
+      Returns false if there is nothing left to tick and the square can be removed from the ticking squares.*/
+  bool tick(Position);
 
   void getViewIndex(const ContentFactory*, ViewIndex&, const Creature* viewer) const;
 
@@ -93,7 +89,7 @@ class Square {
   bool needsMemoryUpdate() const;
   void setMemoryUpdated();
 
-  void clearItemIndex(ItemIndex);
+  void clearItemIndex(Position, ItemIndex);
   void setDirty(Position);
 
   const Inventory& getInventory() const;
@@ -101,13 +97,21 @@ class Square {
   template <class Archive>
   void serialize(Archive&, const unsigned int);
 
+  /** Returns gas amounts loaded from an old save, to be moved to the level's TileGas.*/
+  heap_optional<SquareGasAmounts> takeLegacyGas();
+
   private:
-  HeapAllocated<Inventory> SERIAL(inventory);
+  template <class Archive>
+  void serializeLegacy(Archive&);
+  // Most squares never hold items and are never rendered, so these are only allocated on first use.
+  heap_optional<Inventory> SERIAL(inventory);
   Creature* SERIAL(creature) = nullptr;
   optional<StairKey> SERIAL(landingLink);
-  HeapAllocated<TileGas> SERIAL(tileGas);
   mutable optional<UniqueEntity<Creature>::Id> SERIAL(lastViewer);
-  unique_ptr<ViewIndex> SERIAL(viewIndex);
+  mutable unique_ptr<ViewIndex> SERIAL(viewIndex);
   optional<TribeId> SERIAL(forbiddenTribe);
+  heap_optional<SquareGasAmounts> legacyGas;
   bool SERIAL(onFire) = false;
 };
+
+CEREAL_CLASS_VERSION(Square, 1)
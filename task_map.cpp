@@ -21,6 +21,7 @@ void TaskMap::serialize(Archive& ar, const unsigned int) {
         addToTaskByActivity(task, activity);
       cantPerformByAnyone[activity].clear();
     }
+    reevaluateAll = true;
   }
   ar(tasks, positionMap, reversePositions, taskByCreature, creatureByTask, marked, completionCost, priorityTasks, delayedTasks, highlight, taskById, taskByActivity, activityByTask);
   if (Archive::is_loading::value) {
@@ -36,29 +37,57 @@ SERIALIZABLE(TaskMap);
 
 SERIALIZATION_CONSTRUCTOR_IMPL(TaskMap);
 
+void TaskMap::setDirty(Task* task) {
+  if (!dirtyTaskSet.contains(task)) {
+    dirtyTaskSet.insert(task);
+    dirtyTasks.push_back(task->getUniqueId());
+  }
+}
+
+void TaskMap::updateReachability(Position pos) {
+  if (auto tasks = getReferenceMaybe(reversePositions, pos))
+    for (auto task : *tasks)
+      setDirty(task);
+}
+
+void TaskMap::updateCanPerform(Task* task, MinionActivity activity) {
+  if (!task->canPerformByAnyone()) {
+    priorityTaskByActivity[activity].removeMaybe(task);
+    if (taskByActivity[activity].removeElementMaybe(task))
+      cantPerformByAnyone[activity].push_back(task);
+  } else if (cantPerformByAnyone[activity].removeElementMaybe(task))
+    addToTaskByActivity(task, activity);
+}
+
+void TaskMap::checkCanPerform() const {
+  for (auto activity : ENUM_ALL(MinionActivity)) {
+    for (auto task : taskByActivity[activity])
+      CHECK(task->canPerformByAnyone()) << "Task should be unavailable: " << task->getDescription();
+    for (auto task : priorityTaskByActivity[activity].getElems())
+      CHECK(task->canPerformByAnyone()) << "Priority task should be unavailable: " << task->getDescription();
+    for (auto task : cantPerformByAnyone[activity])
+      CHECK(!task->canPerformByAnyone()) << "Task should be available: " << task->getDescription();
+  }
+}
+
 void TaskMap::tick() {
   for (Task* t : getWeakPointers(tasks)) {
     if (t->isDone())
       removeTask(t);
   }
-  for (auto activity : ENUM_ALL(MinionActivity)) {
-    for (auto task : Iter(taskByActivity[activity]))
-      if (!(*task)->canPerformByAnyone()) {
-        task.markToErase();
-        cantPerformByAnyone[activity].push_back(*task);
-      }
-    EntitySet<Task> toErase;
-    for (auto task : priorityTaskByActivity[activity].getElems())
-      if (!task->canPerformByAnyone())
-        toErase.insert(task);
-    for (auto& elem : toErase)
-      priorityTaskByActivity[activity].remove(elem);
-    for (auto task : Iter(cantPerformByAnyone[activity]))
-      if ((*task)->canPerformByAnyone()) {
-        task.markToErase();
-        addToTaskByActivity(*task, activity);
-      }
+  if (reevaluateAll) {
+    for (auto& task : tasks)
+      setDirty(task.get());
+    reevaluateAll = false;
   }
+  for (auto id : dirtyTasks)
+    if (auto task = taskById.getMaybe(id))
+      if (auto activity = activityByTask.getMaybe(*task))
+        updateCanPerform(*task, *activity);
+  dirtyTasks.clear();
+  dirtyTaskSet.clear();
+  if (canPerformCheck.isDue())
+    checkCanPerform();
 }
 
 Task* TaskMap::getClosestTask(const Creature* creature, MinionActivity activity, bool priorityOnly,
@@ -121,6 +150,7 @@ void TaskMap::setPriorityTask(Task* task) {
   if (auto activity = activityByTask.getMaybe(task))
     priorityTaskByActivity[*activity].insertIfDoesntContain(task);
   priorityTasks.insert(task);
+  setDirty(task);
 }
 
 Task* TaskMap::addTaskCost(PTask task, Position position, CostInfo cost, MinionActivity activity) {
@@ -267,6 +297,7 @@ Task* TaskMap::addTask(PTask task, Position position, MinionActivity activity) {
   taskByActivity[activity].push_back(task.get());
   CHECK(!activityByTask.getMaybe(task.get()));
   activityByTask.set(task.get(), activity);
+  setDirty(task.get());
   tasks.push_back(std::move(task));
   return tasks.back().get();
 }
@@ -43,6 +43,9 @@ class TaskMap {
   Task* getTask(UniqueEntity<Task>::Id) const;
   void tick();
   optional<MinionActivity> getTaskActivity(Task*) const;
+  /** Must be called when something that Task::canPerformByAnyone() depends on changes for tasks at the position,
+      e.g. the tile became known or the position matching changed. Only such tasks are re-evaluated in tick().*/
+  void updateReachability(Position);
 
   SERIALIZATION_DECL(TaskMap)
 
@@ -61,6 +64,13 @@ class TaskMap {
   EnumMap<MinionActivity, vector<Task*>> SERIAL(taskByActivity);
   EnumMap<MinionActivity, IndexedVector<Task*, UniqueEntity<Task>::Id>> priorityTaskByActivity;
   EnumMap<MinionActivity, vector<Task*>> cantPerformByAnyone;
+  vector<UniqueEntity<Task>::Id> dirtyTasks;
+  EntitySet<Task> dirtyTaskSet;
+  bool reevaluateAll = true;
+  void setDirty(Task*);
+  void updateCanPerform(Task*, MinionActivity);
+  void checkCanPerform() const;
+  CacheCheck canPerformCheck;
   EntityMap<Task, MinionActivity> SERIAL(activityByTask);
   void releaseOnHoldTask(Task*);
   void setPosition(Task*, Position);
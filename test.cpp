@@ -48,6 +48,7 @@
 #include "biome_id.h"
 #include "item_types.h"
 #include "creature_attributes.h"
+#include "tile_gas.h"
 
 class Test {
   public:
@@ -582,8 +583,14 @@ class Test {
       CHECKEQ(w1->x, 2);
       CHECK(!!w2);
       CHECKEQ(w2->x, 1);
+      WeakPointer<tmp> w3 = w1;
+      WeakPointer<tmp> w5 = std::move(w3);
+      CHECK(!w3);
+      CHECK(w5 == w1);
+      CHECKEQ(w5.getHash(), w1.getHash());
       t3 = std::move(t2);
       CHECK(!w1);
+      CHECK(!w5);
       CHECK(!!w2);
     }
     CHECK(!w1);
@@ -1105,6 +1112,17 @@ class Test {
     CHECK(r2.v == 6);
   }
 
+  void testPrettyInputErrorPosition() {
+    map<string, TestStruct2> m;
+    string text = "Def MAKE(val) { v = val }\nEnd\n"
+        "\"r1\" MAKE(1)\n"
+        "\"r2\" MAKE(x)\n";
+    auto err = PrettyPrinting::parseObject(m, {text}, {"test.txt"});
+    CHECK(!!err);
+    CHECKEQ(*err, "test.txt: line: 1 column: 20:\ntest.txt: line: 4 column: 10:\nError reading value of type: "_s
+        + typeid(int).name());
+  }
+
   void testPrettyVector() {
     map<string, TestStruct2> m;
     string text = "{"
@@ -1151,6 +1169,142 @@ class Test {
     CHECK(res == makeVec(1, 2, 3, 4, 5, 6, 7, 8)) << res;
   }
 
+  void testLevelBuilderRollback() {
+    auto contentFactory = getContentFactory();
+    LevelBuilder builder(nullptr, Random, &contentFactory, 10, 10, false, none);
+    builder.putFurniture(Vec2(1, 1), FurnitureType("FLOOR"));
+    builder.addAttrib(Vec2(1, 1), SquareAttrib::LOWLAND);
+    auto checkpoint = builder.checkpoint();
+    builder.pushMap(Rectangle(2, 2, 6, 6), LevelBuilder::CW1);
+    builder.resetFurniture(Vec2(3, 3), FurnitureType("MOUNTAIN"));
+    builder.removeAttrib(Vec2(1, 1), SquareAttrib::LOWLAND);
+    builder.removeFurniture(Vec2(1, 1), FurnitureLayer::GROUND);
+    builder.setCovered(Vec2(3, 3), true);
+    builder.rollback(checkpoint);
+    CHECK(builder.isFurnitureType(Vec2(1, 1), FurnitureType("FLOOR")));
+    CHECK(builder.hasAttrib(Vec2(1, 1), SquareAttrib::LOWLAND));
+    for (Vec2 v : Rectangle(10, 10))
+      CHECK(!builder.isFurnitureType(v, FurnitureType("MOUNTAIN")));
+    checkpoint = builder.checkpoint();
+    builder.putFurniture(Vec2(4, 4), FurnitureType("MOUNTAIN"));
+    builder.commit(checkpoint);
+    CHECK(builder.isFurnitureType(Vec2(4, 4), FurnitureType("MOUNTAIN")));
+  }
+
+  void testRandomSubstreamOrder() {
+    auto draw = [](RandomGen& gen) {
+      vector<int> ret;
+      for (int i : Range(20))
+        ret.push_back(gen.get(1000));
+      return ret;
+    };
+    RandomGen root1;
+    root1.init(1234);
+    RandomGen root2;
+    root2.init(1234);
+    const int level = 3;
+    auto creature1 = root1.substream(level, 1, 100);
+    auto values1 = draw(creature1);
+    auto creature2 = root1.substream(level, 2, 100);
+    auto values2 = draw(creature2);
+    // Evaluate in reverse order and consume the parent in between.
+    root2.get(1000);
+    auto creature2b = root2.substream(level, 2, 100);
+    auto values2b = draw(creature2b);
+    root2.getDouble();
+    auto creature1b = root2.substream(level, 1, 100);
+    auto values1b = draw(creature1b);
+    CHECK(values1 == values1b);
+    CHECK(values2 == values2b);
+    CHECK(values1 != values2);
+    auto nextTurn = root1.substream(level, 1, 101);
+    CHECK(draw(nextTurn) != values1);
+  }
+
+  // The per-square update that TileGas used before it was moved to a dense per-level field.
+  void tickGasReference(Vec2 size, double spread, double decrease, const vector<char>& open,
+      const vector<float>& permanent, vector<float>& total) {
+    for (int x : Range(size.x))
+      for (int y : Range(size.y)) {
+        auto index = x * size.y + y;
+        auto& value = total[index];
+        if (value - permanent[index] < 0.1) {
+          value = permanent[index];
+          continue;
+        }
+        for (auto dir : Vec2::directions8()) {
+          auto v = Vec2(x, y) + dir;
+          if (!v.inRectangle(Rectangle(size)))
+            continue;
+          auto neighbor = v.x * size.y + v.y;
+          if (open[neighbor] && value > permanent[index] && total[neighbor] < value) {
+            double transfer = dir.isCardinal4() ? spread : spread / 2;
+            transfer = min<double>(value - permanent[index], transfer);
+            transfer = min<double>((value - total[neighbor]) / 2, transfer);
+            value -= transfer;
+            total[neighbor] = min<double>(1, total[neighbor] + transfer);
+          }
+        }
+        value = max<double>(permanent[index], permanent[index] + (value - permanent[index]) * decrease);
+      }
+  }
+
+  void testGasDiffusion() {
+    Vec2 size(21, 21);
+    auto getIndex = [&](Vec2 v) { return v.x * size.y + v.y; };
+    const int numSquares = size.x * size.y;
+    vector<char> open(numSquares, 1);
+    for (int y : Range(5, 16))
+      open[getIndex(Vec2(14, y))] = 0;
+    vector<float> permanent(numSquares, 0);
+    permanent[getIndex(Vec2(2, 2))] = 0.5;
+    vector<float> total = permanent;
+    vector<float> reference = permanent;
+    vector<float> next(numSquares);
+    auto source = getIndex(Vec2(10, 10));
+    optional<int> emptyTime;
+    optional<int> referenceEmptyTime;
+    for (int time : Range(30)) {
+      if (time < 10) {
+        total[source] = min(1.0f, total[source] + 0.5f);
+        reference[source] = min(1.0f, reference[source] + 0.5f);
+      }
+      TileGas::diffuse(size, 0.1, 0.98, open, permanent, total, next);
+      total = next;
+      tickGasReference(size, 0.1, 0.98, open, permanent, reference);
+      bool empty = true;
+      bool referenceEmpty = true;
+      for (int i : Range(numSquares)) {
+        CHECK(fabs(total[i] - reference[i]) < 0.15) << time << " " << total[i] << " " << reference[i];
+        CHECK(total[i] >= permanent[i] && total[i] <= 1);
+        empty &= total[i] == permanent[i];
+        referenceEmpty &= reference[i] == permanent[i];
+      }
+      if (empty && !emptyTime)
+        emptyTime = time;
+      if (referenceEmpty && !referenceEmptyTime)
+        referenceEmptyTime = time;
+    }
+    CHECK(!!emptyTime && !!referenceEmptyTime && abs(*emptyTime - *referenceEmptyTime) <= 1);
+    for (int y : Range(5, 16))
+      CHECK(total[getIndex(Vec2(14, y))] == 0);
+    CHECK(total[getIndex(Vec2(2, 2))] == 0.5f);
+    // Without walls the result doesn't depend on the order in which squares are visited.
+    vector<char> allOpen(numSquares, 1);
+    vector<float> noPermanent(numSquares, 0);
+    vector<float> symmetric(numSquares, 0);
+    symmetric[source] = 1;
+    for (int time : Range(5)) {
+      TileGas::diffuse(size, 0.1, 0.98, allOpen, noPermanent, symmetric, next);
+      symmetric = next;
+      for (int x : Range(size.x))
+        for (int y : Range(size.y)) {
+          CHECK(fabs(symmetric[getIndex(Vec2(x, y))] - symmetric[getIndex(Vec2(size.x - 1 - x, y))]) < 1e-6);
+          CHECK(fabs(symmetric[getIndex(Vec2(x, y))] - symmetric[getIndex(Vec2(y, x))]) < 1e-6);
+        }
+    }
+  }
+
   struct MatchingTest {
     MatchingTest() {
       auto contentFactory = getContentFactory();
@@ -1223,6 +1377,80 @@ class Test {
       t.matching.addTarget(t.get(v.x, v.y));
   }
 
+  void testForestFire() {
+    auto contentFactory = getContentFactory();
+    auto model = Model::create(&contentFactory, none, BiomeId("GRASSLAND"));
+    LevelBuilder builder(nullptr, Random, &contentFactory, 20, 20, false, none);
+    PLevelMaker levelMaker = LevelMaker::emptyLevel(FurnitureType("DECID_TREE"), true);
+    auto level = model->buildMainLevel(&contentFactory, std::move(builder), std::move(levelMaker));
+    auto game = Game::splashScreen(std::move(model), CampaignBuilder::getEmptyCampaign(), std::move(contentFactory),
+        nullptr);
+    vector<Position> clearings;
+    for (auto v : level->getBounds())
+      if ((v.x + v.y) % 3 == 0) {
+        Position pos(v, level);
+        pos.removeFurniture(pos.getFurniture(FurnitureLayer::MIDDLE));
+        clearings.push_back(pos);
+      }
+    Position start(Vec2(10, 11), level);
+    CHECK(start.modFurniture(FurnitureLayer::MIDDLE)->fireDamage(start, false));
+    int numTicks = 0;
+    for (; numTicks < 2000; ++numTicks) {
+      level->tick();
+      for (auto& pos : clearings)
+        CHECK(pos.canEnterEmpty({MovementTrait::WALK}) == !pos.isBurning()) << pos.getCoord() << " " << numTicks;
+      bool burning = false;
+      for (auto pos : level->getAllPositions())
+        burning |= pos.isBurning();
+      if (!burning)
+        break;
+    }
+    CHECK(numTicks < 2000);
+    int numBurnt = 0;
+    for (auto pos : level->getAllPositions())
+      if (auto f = pos.getFurniture(FurnitureLayer::MIDDLE))
+        if (f->getType() == FurnitureType("BURNT_TREE"))
+          ++numBurnt;
+    CHECK(numBurnt > 200) << numBurnt;
+  }
+
+  // Builds a fully dug ground level with items on some squares and several z-levels above it, then prints
+  // the average time of Level::tick() on each level.
+  void benchmarkLevelTick() {
+    auto contentFactory = getContentFactory();
+    auto model = Model::create(&contentFactory, none, BiomeId("GRASSLAND"));
+    const int size = 120;
+    vector<Level*> levels;
+    levels.push_back(model->buildMainLevel(&contentFactory, LevelBuilder(Random, &contentFactory, size, size, false),
+        LevelMaker::emptyLevel(FurnitureType("FLOOR"), false)));
+    for (int i : Range(3)) {
+      LevelBuilder builder(Random, &contentFactory, size, size, false);
+      for (auto v : Rectangle(size, size))
+        builder.setUnavailable(v);
+      levels.push_back(model->buildUpLevel(&contentFactory, std::move(builder),
+          LevelMaker::emptyLevel(FurnitureType("GRASS"), false)));
+    }
+    auto items = ItemType(CustomItemId("Bow"));
+    auto game = Game::splashScreen(std::move(model), CampaignBuilder::getEmptyCampaign(), std::move(contentFactory),
+        nullptr);
+    for (auto pos : levels[0]->getAllPositions())
+      pos.dropItem(items.get(game->getContentFactory()));
+    for (auto pos : levels[0]->getAllPositions())
+      if (pos.getCoord().x % 10 != 0)
+        pos.removeItems(pos.getItems());
+    for (int i : Range(10))
+      for (auto level : levels)
+        level->tick();
+    const int numTicks = 500;
+    for (auto level : levels) {
+      auto begin = std::chrono::steady_clock::now();
+      for (int i : Range(numTicks))
+        level->tick();
+      auto micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+      std::cout << level->name << ": " << micros / numTicks << " us per tick" << std::endl;
+    }
+  }
+
   void testDungeonLevel() {
     DungeonLevel level;
     CHECKEQ(level.level, 0);
@@ -1295,6 +1523,10 @@ class Test {
   }
 };
 
+void benchmarkLevelTick() {
+  Test().benchmarkLevelTick();
+}
+
 void testAll() {
   Test().testStringConvertion();
   Test().testTimeQueue();
@@ -1348,10 +1580,14 @@ void testAll() {
   Test().testCacheTemplate();
   Test().testCacheTemplate2();
   Test().testTextSerialization();
+  Test().testLevelBuilderRollback();
+  Test().testRandomSubstreamOrder();
+  Test().testGasDiffusion();
   Test().testPositionMatching1();
   Test().testPositionMatching2();
   Test().testPositionMatching3();
   Test().testPositionMatching4();
+  Test().testForestFire();
   Test().testDungeonLevel();
   Test().testPrettyInput();
   Test().testPrettyInput2();
@@ -1364,6 +1600,7 @@ void testAll() {
   Test().testPrettyInput9();
   Test().testPrettyInput10();
   Test().testPrettyInput11();
+  Test().testPrettyInputErrorPosition();
   Test().testPrettyVector();
   Test().testPrettyVector2();
   Test().testPrettyVector3();
@@ -1379,6 +1616,7 @@ void testAll() {
 
 #else
 void testAll() {}
+void benchmarkLevelTick() {}
 
 #endif
 
@@ -21,71 +21,206 @@
 #include "content_factory.h"
 #include "tile_gas_info.h"
 
-SERIALIZE_DEF(TileGas, amount)
+SERIALIZE_DEF(TileGas, bounds, layers)
+
+TileGas::TileGas(Rectangle b) : bounds(b) {}
+
+TileGas::TileGas() {}
 
 double TileGas::getFogVisionCutoff() {
   return 0.2;
 }
 
+int TileGas::getIndex(Vec2 v) const {
+  return (v.x - bounds.left()) * bounds.height() + v.y - bounds.top();
+}
+
+TileGas::Layer& TileGas::getLayer(TileGasType type) {
+  for (auto& layer : layers)
+    if (layer.type == type)
+      return layer;
+  layers.push_back(Layer{type, vector<float>(bounds.area(), 0), vector<float>(bounds.area(), 0), none});
+  return layers.back();
+}
+
+const TileGas::Layer* TileGas::getLayerMaybe(TileGasType type) const {
+  for (auto& layer : layers)
+    if (layer.type == type)
+      return &layer;
+  return nullptr;
+}
+
+void TileGas::setActive(Layer& layer, Vec2 v) {
+  if (!layer.active)
+    layer.active = Rectangle(v, v + Vec2(1, 1));
+  else
+    layer.active = Rectangle(min(v.x, layer.active->left()), min(v.y, layer.active->top()),
+        max(v.x + 1, layer.active->right()), max(v.y + 1, layer.active->bottom()));
+}
+
 void TileGas::addAmount(Position pos, TileGasType t, double a) {
   CHECK(a > 0);
-  auto prevValue = amount[t].total;
-  amount[t].total = min(1., a + amount[t].total);
-  if (prevValue < getFogVisionCutoff() && amount[t].total >= getFogVisionCutoff()) {
+  if (!pos.canSeeThruIgnoringGas(VisionId::NORMAL))
+    return;
+  auto& layer = getLayer(t);
+  auto& value = layer.total[getIndex(pos.getCoord())];
+  auto prevValue = value;
+  value = min(1.0f, float(a) + value);
+  setActive(layer, pos.getCoord());
+  pos.setNeedsRenderAndMemoryUpdate(true);
+  if (prevValue < getFogVisionCutoff() && value >= getFogVisionCutoff()) {
     if (pos.getGame()->getContentFactory()->tileGasTypes.at(t).blocksVision)
       pos.updateVisibility();
     pos.updateConnectivity();
   }
 }
 
-void TileGas::addPermanentAmount(TileGasType t, double a) {
-  auto& values = amount[t];
-  values.total = min(1.0, values.total + a);
-  values.permanent = min(1.0, values.permanent + a);
+void TileGas::addPermanentAmount(Vec2 v, TileGasType t, double a) {
+  auto& layer = getLayer(t);
+  auto index = getIndex(v);
+  layer.total[index] = min(1.0f, layer.total[index] + float(a));
+  layer.permanent[index] = min(1.0f, layer.permanent[index] + float(a));
 }
 
-bool TileGas::hasSunlightBlockingAmount() const {
-  for (auto& elem : amount)
-    if (elem.second.total > getFogVisionCutoff())
+void TileGas::addLegacyAmounts(Vec2 v, const SquareGasAmounts& amounts) {
+  for (auto& elem : amounts.amount) {
+    auto& layer = getLayer(elem.first);
+    auto index = getIndex(v);
+    layer.total[index] = elem.second.total;
+    layer.permanent[index] = elem.second.permanent;
+    if (elem.second.total > elem.second.permanent)
+      setActive(layer, v);
+  }
+}
+
+bool TileGas::hasSunlightBlockingAmount(Vec2 v) const {
+  auto index = getIndex(v);
+  for (auto& layer : layers)
+    if (layer.total[index] > getFogVisionCutoff())
       return true;
   return false;
 }
 
-void TileGas::tick(Position pos) {
+double TileGas::getAmount(Vec2 v, TileGasType type) const {
+  if (auto layer = getLayerMaybe(type))
+    return layer->total[getIndex(v)];
+  return 0;
+}
+
+void TileGas::diffuse(Vec2 size, double spread, double decrease, const vector<char>& open,
+    const vector<float>& permanent, const vector<float>& current, vector<float>& next) {
+  DiffuseBuffers buffers;
+  diffuse(size, spread, decrease, open, permanent, current, next, buffers);
+}
+
+void TileGas::diffuse(Vec2 size, double spread, double decrease, const vector<char>& open,
+    const vector<float>& permanent, const vector<float>& current, vector<float>& next, DiffuseBuffers& buffers) {
   PROFILE;
-  for (auto& elem : amount) {
-    auto& value = elem.second;
-    auto prevValue = value.total;
-    auto& info = pos.getGame()->getContentFactory()->tileGasTypes.at(elem.first);
-    if (info.effect && value.total > 0.01 && Random.chance(value.total))
-      info.effect->apply(pos);
-    if (value.total - value.permanent < 0.1)
-      value.total = value.permanent;
-    else {
-      if (info.spread > 0)
-        for (Position v : pos.neighbors8(Random)) {
-          if (v.canSeeThruIgnoringGas(VisionId::NORMAL) && value.total - value.permanent > 0 &&
-              v.getGasAmount(elem.first) < value.total) {
-            double transfer = pos.getDir(v).isCardinal4() ? info.spread : info.spread / 2;
-            transfer = min(value.total - value.permanent, transfer);
-            transfer = min((value.total - v.getGasAmount(elem.first)) / 2, transfer);
-            value.total -= transfer;
-            CHECK(value.total >= value.permanent);
-            v.addGas(elem.first, transfer);
+  const int width = size.x;
+  const int height = size.y;
+  const float cardinalSpread = spread;
+  const float diagonalSpread = spread / 2;
+  // The amount sent by a square is computed from the state at the start of the step, so the result doesn't
+  // depend on the order in which squares are visited. If the sum of transfers exceeds the square's non-permanent
+  // amount then all of them are scaled down.
+  auto& scale = buffers.scale;
+  auto& sent = buffers.sent;
+  scale.clear();
+  scale.resize(width * height);
+  sent.clear();
+  sent.resize(width * height);
+  auto getTransfer = [&] (int from, int to, float maxTransfer) {
+    return (open[to] && current[to] < current[from]) ? min(maxTransfer, (current[from] - current[to]) / 2) : 0.0f;
+  };
+  for (int x = 0; x < width; ++x)
+    for (int y = 0; y < height; ++y) {
+      const int index = x * height + y;
+      const float excess = current[index] - permanent[index];
+      if (spread <= 0 || excess < 0.1)
+        continue;
+      float out = 0;
+      for (int dx = -1; dx <= 1; ++dx)
+        for (int dy = -1; dy <= 1; ++dy)
+          if ((dx != 0 || dy != 0) && x + dx >= 0 && x + dx < width && y + dy >= 0 && y + dy < height)
+            out += getTransfer(index, index + dx * height + dy, (dx == 0 || dy == 0) ? cardinalSpread : diagonalSpread);
+      scale[index] = out > excess ? excess / out : 1;
+      sent[index] = min(out, excess);
+    }
+  for (int x = 0; x < width; ++x)
+    for (int y = 0; y < height; ++y) {
+      const int index = x * height + y;
+      const float excess = current[index] - permanent[index];
+      const float remaining = excess < 0.1 ? 0.0f : max(0.0f, (excess - sent[index]) * float(decrease));
+      float received = 0;
+      for (int dx = -1; dx <= 1; ++dx)
+        for (int dy = -1; dy <= 1; ++dy)
+          if ((dx != 0 || dy != 0) && x + dx >= 0 && x + dx < width && y + dy >= 0 && y + dy < height) {
+            const int neighbor = index + dx * height + dy;
+            if (scale[neighbor] > 0)
+              received += scale[neighbor] *
+                  getTransfer(neighbor, index, (dx == 0 || dy == 0) ? cardinalSpread : diagonalSpread);
           }
-        }
-      value.total = max(value.permanent, value.permanent + (value.total - value.permanent) * info.decrease);
+      next[index] = min(1.0f, permanent[index] + remaining + received);
+    }
+}
+
+void TileGas::tickLayer(Level* level, int layerIndex, const TileGasInfo& info) {
+  if (info.effect) {
+    // Effects can add gas, which may reallocate the layers, so they are not referenced during this loop.
+    auto area = *layers[layerIndex].active;
+    for (Vec2 v : area) {
+      auto value = layers[layerIndex].total[getIndex(v)];
+      if (value > 0.01 && Random.chance(value))
+        info.effect->apply(Position(v, level));
     }
-    if (prevValue >= getFogVisionCutoff() && value.total < getFogVisionCutoff()) {
-      if (info.blocksVision)
-        pos.updateVisibility();
-      pos.updateConnectivity();
+  }
+  auto& layer = layers[layerIndex];
+  auto region = layer.active->minusMargin(-1).intersection(bounds);
+  const auto area = region.area();
+  // Every element in the region is written below, so the buffers only need the right size.
+  auto& open = scratch.open;
+  auto& permanent = scratch.permanent;
+  auto& current = scratch.current;
+  auto& next = scratch.next;
+  open.resize(area);
+  permanent.resize(area);
+  current.resize(area);
+  next.resize(area);
+  auto getRegionIndex = [&] (Vec2 v) {
+    return (v.x - region.left()) * region.height() + v.y - region.top();
+  };
+  for (Vec2 v : region) {
+    auto index = getRegionIndex(v);
+    open[index] = Position(v, level).canSeeThruIgnoringGas(VisionId::NORMAL);
+    permanent[index] = layer.permanent[getIndex(v)];
+    current[index] = layer.total[getIndex(v)];
+  }
+  diffuse(region.getSize(), info.spread, info.decrease, open, permanent, current, next, scratch.diffuse);
+  layer.active = none;
+  vector<Position> crossedCutoff;
+  for (Vec2 v : region) {
+    auto index = getRegionIndex(v);
+    if (next[index] != current[index]) {
+      layer.total[getIndex(v)] = next[index];
+      Position pos(v, level);
+      pos.setNeedsRenderAndMemoryUpdate(true);
+      if ((current[index] >= getFogVisionCutoff()) != (next[index] >= getFogVisionCutoff()))
+        crossedCutoff.push_back(pos);
     }
+    if (next[index] > permanent[index])
+      setActive(layer, v);
+  }
+  for (auto& pos : crossedCutoff) {
+    if (info.blocksVision)
+      pos.updateVisibility();
+    pos.updateConnectivity();
   }
 }
 
-double TileGas::getAmount(TileGasType type) const {
-  if (auto res = getReferenceMaybe(amount, type))
-    return res->total;
-  return 0;
+void TileGas::tick(Level* level) {
+  PROFILE;
+  auto factory = level->getGame()->getContentFactory();
+  for (int i : Range(layers.size()))
+    if (layers[i].active)
+      tickLayer(level, i, factory->tileGasTypes.at(layers[i].type));
 }
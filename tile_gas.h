@@ -20,24 +20,69 @@
 #include "tile_gas_type.h"
 
 class Level;
+struct TileGasInfo;
 
+// Gas amounts of a single square, as stored in saves from before gas was kept in TileGas per level.
+struct SquareGasAmounts {
+  struct AmountInfo {
+    double SERIAL(total);
+    double SERIAL(permanent);
+    SERIALIZE_ALL(total, permanent)
+  };
+  HashMap<TileGasType, AmountInfo> SERIAL(amount);
+  SERIALIZE_ALL(amount)
+};
+
+/** Gas amounts of all squares of a level, stored as one dense layer per gas type.
+    Each tick only the rectangle of a layer that contains non-permanent gas is simulated.*/
 class TileGas {
   public:
+  TileGas(Rectangle bounds);
+  TileGas();
   void addAmount(Position, TileGasType, double amount);
-  void addPermanentAmount(TileGasType, double amount);
-  void tick(Position);
-  double getAmount(TileGasType) const;
+  void addPermanentAmount(Vec2, TileGasType, double amount);
+  void tick(Level*);
+  double getAmount(Vec2, TileGasType) const;
   static double getFogVisionCutoff();
-  bool hasSunlightBlockingAmount() const;
+  bool hasSunlightBlockingAmount(Vec2) const;
+
+  // One diffusion step over a region. All arrays are indexed like Table, i.e. x * size.y + y.
+  static void diffuse(Vec2 size, double spread, double decrease, const vector<char>& open,
+      const vector<float>& permanent, const vector<float>& current, vector<float>& next);
+  struct DiffuseBuffers {
+    vector<float> scale;
+    vector<float> sent;
+  };
+  static void diffuse(Vec2 size, double spread, double decrease, const vector<char>& open,
+      const vector<float>& permanent, const vector<float>& current, vector<float>& next, DiffuseBuffers&);
 
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version);
 
+  void addLegacyAmounts(Vec2, const SquareGasAmounts&);
+
   private:
-  struct AmountInfo {
-    double SERIAL(total);
-    double SERIAL(permanent);
-    SERIALIZE_ALL(total, permanent)
+  struct Layer {
+    TileGasType SERIAL(type);
+    vector<float> SERIAL(total);
+    vector<float> SERIAL(permanent);
+    optional<Rectangle> SERIAL(active);
+    SERIALIZE_ALL(type, total, permanent, active)
   };
-  HashMap<TileGasType, AmountInfo> SERIAL(amount);
+  int getIndex(Vec2) const;
+  Layer& getLayer(TileGasType);
+  const Layer* getLayerMaybe(TileGasType) const;
+  void setActive(Layer&, Vec2);
+  void tickLayer(Level*, int layerIndex, const TileGasInfo&);
+  Rectangle SERIAL(bounds);
+  vector<Layer> SERIAL(layers);
+  // Reused by tickLayer() so that ticking doesn't allocate.
+  struct Scratch {
+    vector<char> open;
+    vector<float> permanent;
+    vector<float> current;
+    vector<float> next;
+    DiffuseBuffers diffuse;
+  };
+  Scratch scratch;
 };
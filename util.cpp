@@ -18,10 +18,67 @@
 #include "util.h"
 #include <time.h>
 
+static uint64_t mixBits(uint64_t a, uint64_t b) {
+  uint64_t z = a ^ (b + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2));
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+PhiloxEngine::PhiloxEngine(uint64_t k, uint64_t s) : key(k), stream(s) {
+}
+
+void PhiloxEngine::seed(uint64_t k) {
+  key = k;
+  stream = 0;
+  blockIndex = 0;
+  outputIndex = 4;
+}
+
+PhiloxEngine PhiloxEngine::substream(uint64_t id) const {
+  return PhiloxEngine(mixBits(key, stream), id);
+}
+
+static void mulHiLo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) {
+  uint64_t product = uint64_t(a) * uint64_t(b);
+  hi = uint32_t(product >> 32);
+  lo = uint32_t(product);
+}
+
+void PhiloxEngine::generateBlock() {
+  uint32_t c[4] = {uint32_t(blockIndex), uint32_t(blockIndex >> 32), uint32_t(stream), uint32_t(stream >> 32)};
+  uint32_t k0 = uint32_t(key);
+  uint32_t k1 = uint32_t(key >> 32);
+  for (int round = 0; round < 10; ++round) {
+    uint32_t hi0, lo0, hi1, lo1;
+    mulHiLo(0xD2511F53u, c[0], hi0, lo0);
+    mulHiLo(0xCD9E8D57u, c[2], hi1, lo1);
+    c[0] = hi1 ^ c[1] ^ k0;
+    c[1] = lo1;
+    c[2] = hi0 ^ c[3] ^ k1;
+    c[3] = lo0;
+    k0 += 0x9E3779B9u;
+    k1 += 0xBB67AE85u;
+  }
+  for (int i = 0; i < 4; ++i)
+    output[i] = c[i];
+  ++blockIndex;
+  outputIndex = 0;
+}
+
+PhiloxEngine::result_type PhiloxEngine::operator()() {
+  if (outputIndex == 4)
+    generateBlock();
+  return output[outputIndex++];
+}
+
 RandomGen::RandomGen() {
   PROFILE;
 }
 
+RandomGen::RandomGen(const PhiloxEngine& e) : generator(e) {
+}
+
 void RandomGen::init(int seed) {
   PROFILE;
   generator.seed(seed);
@@ -702,11 +702,42 @@ class EnumSet {
 
 std::string operator "" _s(const char* str, size_t);
 
+// Philox4x32-10 counter based engine. The output is a pure function of (key, stream, block index), so
+// substreams can be split off without consuming anything from the parent.
+class PhiloxEngine {
+  public:
+  using result_type = uint32_t;
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return 0xffffffffu; }
+  PhiloxEngine(uint64_t key = 0, uint64_t stream = 0);
+  void seed(uint64_t key);
+  result_type operator()();
+  PhiloxEngine substream(uint64_t id) const;
+
+  private:
+  void generateBlock();
+  uint64_t key;
+  uint64_t stream;
+  uint64_t blockIndex = 0;
+  uint32_t output[4];
+  int outputIndex = 4;
+};
+
 class RandomGen {
   public:
   RandomGen();
   RandomGen(RandomGen&) = delete;
+  RandomGen(RandomGen&&) = default;
+  RandomGen& operator = (RandomGen&&) = default;
   void init(int seed);
+  // Returns an independent generator identified by the ids, e.g. substream(levelId, creatureId, turn).
+  // The result doesn't depend on how much of this generator has been consumed.
+  template <typename... Ids>
+  RandomGen substream(Ids... ids) const {
+    RandomGen ret(generator);
+    ret.descend(ids...);
+    return ret;
+  }
   int get(int max);
   long long getLL();
   int get(int min, int max);
@@ -874,7 +905,14 @@ class RandomGen {
   }
 
   private:
-  std::mt19937 generator;
+  RandomGen(const PhiloxEngine&);
+  void descend() {}
+  template <typename Id, typename... Ids>
+  void descend(Id id, Ids... ids) {
+    generator = generator.substream(uint64_t(id));
+    descend(ids...);
+  }
+  PhiloxEngine generator;
   std::uniform_real_distribution<double> defaultDist;
 
   template <typename T>
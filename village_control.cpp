@@ -42,6 +42,8 @@
 #include "team_order.h"
 #include "duel_state.h"
 
+static const ContentIdConstant<BuffId> bridgeBuildingSkill("BRIDGE_BUILDING_SKILL");
+
 SERIALIZATION_CONSTRUCTOR_IMPL(VillageControl)
 
 SERIALIZE_DEF(VillageControl, SUBCLASS(CollectiveControl), SUBCLASS(EventListener), behaviour, victims, myItems, stolenItemCount, attackSizes, entries, maxEnemyPower, cancelledAttacks)
@@ -425,8 +427,8 @@ void VillageControl::update(bool currentlyActive) {
   healAllCreatures();
   for (auto& c : collective->getCreatures(MinionTrait::FIGHTER))
     if (c->getBody().isHumanoid())
-      if (!c->isAffected(BuffId("BRIDGE_BUILDING_SKILL")))
-        c->addPermanentEffect(BuffId("BRIDGE_BUILDING_SKILL"), 1, false);
+      if (!c->isAffected(bridgeBuildingSkill))
+        c->addPermanentEffect(bridgeBuildingSkill, 1, false);
   for (auto team : collective->getTeams().getAll()) {
     for (const Creature* c : collective->getTeams().getMembers(team))
       if (!collective->hasTask(c)) {